@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
+
+// --- Packed asset archive format ---
+// Little-endian. A header, then entryCount index records, then the file
+// data. Every entry starts on a packAlignment boundary so it can be handed
+// straight to decoders from the mapping.
+//
+//   PackHeader | PackEntry[entryCount] | pad | data | pad | data ...
+const char packMagic[4] = { 'S', 'R', 'P', 'K' };
+const std::uint32_t packVersion = 1;
+const std::uint32_t packAlignment = 64;
+const int packNameLength = 56;
+
+struct PackHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t entryCount;
+    std::uint32_t reserved;
+};
+
+struct PackEntry {
+    char name[packNameLength];  // NUL-padded file name, no directories
+    std::uint64_t offset;       // from the start of the archive
+    std::uint64_t size;
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader layout");
+static_assert(sizeof(PackEntry) == 72, "PackEntry layout");
+
+// --- Read-only memory view ---
+struct MemoryView {
+    const char* data = nullptr;
+    std::size_t size = 0;
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// --- Memory-mapped file ---
+class MappedFile {
+public:
+    MappedFile() {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { close(); return false; }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) { close(); return false; }
+        void* base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { close(); return false; }
+        view.data = static_cast<const char*>(base);
+        view.size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(); return false; }
+        void* base = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) { close(); return false; }
+        view.data = static_cast<const char*>(base);
+        view.size = static_cast<std::size_t>(st.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (view.data) UnmapViewOfFile(view.data);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (view.data) munmap(const_cast<char*>(view.data), view.size);
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        view = MemoryView();
+    }
+
+    MemoryView contents() const { return view; }
+
+private:
+    MemoryView view;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+// --- Asset archive ---
+// Maps a .pak built by serpent_pack and serves entries as views into the
+// mapping, so loaders can use loadFromMemory without copying.
+class AssetArchive {
+public:
+    bool open(const std::string& path) {
+        if (!file.open(path)) return false;
+        MemoryView all = file.contents();
+        PackHeader header;
+        if (all.size < sizeof(header)) return fail();
+        std::memcpy(&header, all.data, sizeof(header));
+        if (std::memcmp(header.magic, packMagic, 4) != 0 || header.version != packVersion) return fail();
+        if (all.size < sizeof(PackHeader) + std::uint64_t(header.entryCount) * sizeof(PackEntry)) return fail();
+        entries = reinterpret_cast<const PackEntry*>(all.data + sizeof(PackHeader));
+        entryCount = header.entryCount;
+        for (std::uint32_t i = 0; i < entryCount; ++i) {
+            if (entries[i].offset > all.size || entries[i].size > all.size - entries[i].offset) return fail();
+        }
+        return true;
+    }
+
+    bool isOpen() const { return entries != nullptr; }
+
+    // Looks an entry up by file name; directories in the name are ignored.
+    MemoryView find(const std::string& path) const {
+        std::string name = baseName(path);
+        for (std::uint32_t i = 0; i < entryCount; ++i) {
+            if (std::strncmp(entries[i].name, name.c_str(), packNameLength) == 0) {
+                MemoryView v;
+                v.data = file.contents().data + entries[i].offset;
+                v.size = static_cast<std::size_t>(entries[i].size);
+                return v;
+            }
+        }
+        return MemoryView();
+    }
+
+    static std::string baseName(const std::string& path) {
+        std::size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+private:
+    bool fail() {
+        file.close();
+        entries = nullptr;
+        entryCount = 0;
+        return false;
+    }
+
+    MappedFile file;
+    const PackEntry* entries = nullptr;
+    std::uint32_t entryCount = 0;
+};
+
+// --- Executable location ---
+// Directory of the running binary, with a trailing separator, so assets are
+// found no matter which directory the game was started from. Falls back to
+// the working directory when the platform query fails.
+inline std::string executableDir() {
+    std::string path;
+#ifdef _WIN32
+    char buffer[MAX_PATH];
+    DWORD n = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
+    if (n > 0 && n < MAX_PATH) path.assign(buffer, n);
+#elif defined(__APPLE__)
+    char buffer[4096];
+    uint32_t size = sizeof(buffer);
+    if (_NSGetExecutablePath(buffer, &size) == 0) path = buffer;
+#else
+    char buffer[4096];
+    ssize_t n = readlink("/proc/self/exe", buffer, sizeof(buffer));
+    if (n > 0 && n < static_cast<ssize_t>(sizeof(buffer))) path.assign(buffer, static_cast<std::size_t>(n));
+#endif
+    std::size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "game.hpp"
+
+// --- Deterministic random numbers ---
+// rand() is global and differs between C libraries; arenas run side by side
+// on several threads and clients must be able to replay a tick exactly, so
+// each arena carries its own generator (xorshift32).
+struct GameRng {
+    std::uint32_t state = 1;
+
+    explicit GameRng(std::uint32_t seed = 1) : state(seed ? seed : 1) {}
+
+    std::uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    int below(int n) { return static_cast<int>(next() % static_cast<std::uint32_t>(n)); }
+};
+
+// The one turning rule, shared with client-side prediction so both sides
+// step a snake the same way: turning back onto the neck is ignored.
+inline Direction steer(Direction current, Direction wanted) {
+    bool reverse = (wanted == Up && current == Down) || (wanted == Down && current == Up) ||
+                   (wanted == Left && current == Right) || (wanted == Right && current == Left);
+    return reverse ? current : wanted;
+}
+
+inline SnakeSegment stepFrom(SnakeSegment s, Direction dir) {
+    switch (dir) {
+        case Up: s.y--; break;
+        case Down: s.y++; break;
+        case Left: s.x--; break;
+        case Right: s.x++; break;
+    }
+    return s;
+}
+
+// Snapshot coordinates are 16-bit.
+const int maxArenaSide = 4096;
+
+// --- Arena: many snakes on one board ---
+// The single-player rules from game.hpp, shared by every player: walls and
+// bodies kill, apples grow the snake by one and score a point. Dead players
+// respawn after a short delay. The arena keeps its own board instead of the
+// global wallGrid so several arenas can tick on different threads.
+struct ArenaPlayer {
+    std::uint16_t id = 0;
+    std::uint32_t joinSerial = 0;  // unique per join; ids are reused
+    bool alive = false;
+    int score = 0;
+    std::deque<SnakeSegment> body;  // head first
+    Direction dir = Right;
+    Direction nextDir = Right;
+    std::uint32_t respawnTick = 0;
+};
+
+// Every cell of the board records what is on it: nothing, a wall, an apple
+// or the snake whose body covers it. A tick only touches the cells at each
+// head and tail, so it does the same work for snakes of 10 or 10,000
+// segments; only a death walks a whole body, once.
+class Arena {
+public:
+    static constexpr std::uint32_t respawnDelay = 20;  // ticks
+
+    // Cell values. A snake's cells hold its id + 1.
+    static constexpr std::uint16_t emptyCell = 0;
+    static constexpr std::uint16_t foodCell = 0xFFFE;
+    static constexpr std::uint16_t wallCell = 0xFFFF;
+
+    Arena(int cols, int rows, std::uint32_t seed) : cols(cols), rows(rows), rng(seed) {
+        cells.assign(static_cast<std::size_t>(cols) * rows, emptyCell);
+        for (int x = 0; x < cols; ++x) cell(x, 0) = cell(x, rows - 1) = wallCell;
+        for (int y = 0; y < rows; ++y) cell(0, y) = cell(cols - 1, y) = wallCell;
+    }
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    std::uint32_t getTick() const { return tickCount; }
+    bool isWall(int x, int y) const { return cell(x, y) == wallCell; }
+
+    // The player whose body covers the cell, or -1.
+    int ownerAt(int x, int y) const {
+        std::uint16_t c = cell(x, y);
+        return c == emptyCell || c >= foodCell ? -1 : c - 1;
+    }
+
+    // Player ids are small integers, reused after a player leaves, even on
+    // the same tick; joinSerial tells the two apart. The new player spawns
+    // on the next tick.
+    int addPlayer() {
+        std::uint16_t id = 0;
+        while (findPlayer(id)) ++id;
+        ArenaPlayer p;
+        p.id = id;
+        p.joinSerial = ++joinCount;
+        p.respawnTick = tickCount;
+        players.push_back(p);
+        reindex();
+        return id;
+    }
+
+    void removePlayer(int id) {
+        ArenaPlayer* p = findPlayer(id);
+        if (!p) return;
+        clearBody(*p);
+        players.erase(players.begin() + (p - players.data()));
+        reindex();
+    }
+
+    // Turning back onto the neck is ignored, as in the single-player game.
+    void setDirection(int id, Direction dir) {
+        ArenaPlayer* p = findPlayer(id);
+        if (p) p->nextDir = dir;
+    }
+
+    ArenaPlayer* findPlayer(int id) {
+        if (id < 0 || id >= static_cast<int>(slotById.size()) || slotById[id] < 0) return nullptr;
+        return &players[slotById[id]];
+    }
+
+    // Puts a live snake on the board as given, for benchmarks and reports.
+    // The cells must be free.
+    void placeSnake(int id, const std::deque<SnakeSegment>& body, Direction dir) {
+        ArenaPlayer* p = findPlayer(id);
+        if (!p || body.empty()) return;
+        clearBody(*p);
+        p->body = body;
+        p->dir = p->nextDir = dir;
+        p->alive = true;
+        for (const SnakeSegment& s : body) cell(s.x, s.y) = static_cast<std::uint16_t>(p->id + 1);
+    }
+
+    void tick() {
+        ++tickCount;
+
+        // Every tail leaves before any head arrives, so a snake may follow
+        // a tail, its own included, into the cell it is vacating.
+        eaten.clear();
+        for (ArenaPlayer& p : players) {
+            if (!p.alive) continue;
+            p.dir = steer(p.dir, p.nextDir);
+            SnakeSegment head = stepFrom(p.body.front(), p.dir);
+            p.body.push_front(head);
+            if (cell(head.x, head.y) == foodCell) {
+                p.score += 1;
+                eaten.push_back(head);
+            } else {
+                SnakeSegment tail = p.body.back();
+                p.body.pop_back();
+                cell(tail.x, tail.y) = emptyCell;
+            }
+        }
+
+        // Heads claim their cells in one pass. Walls and bodies kill. When
+        // two heads meet on one cell the longer snake takes it and equal
+        // lengths both die, so the outcome never depends on player order.
+        // Two heads on the same apple both grew above, for the same reason.
+        dying.clear();
+        for (ArenaPlayer& p : players) {
+            if (!p.alive) continue;
+            const SnakeSegment head = p.body.front();
+            std::uint16_t& c = cell(head.x, head.y);
+            if (c == emptyCell || c == foodCell) {
+                c = static_cast<std::uint16_t>(p.id + 1);
+                continue;
+            }
+            ArenaPlayer* holder = c == wallCell ? nullptr : &players[slotById[c - 1]];
+            bool headOn = holder && holder != &p && holder->body.front().x == head.x && holder->body.front().y == head.y;
+            if (!headOn || p.body.size() <= holder->body.size()) kill(p);
+            if (headOn && p.body.size() >= holder->body.size()) kill(*holder);
+            if (headOn && p.body.size() > holder->body.size()) c = static_cast<std::uint16_t>(p.id + 1);
+        }
+        for (std::uint16_t id : dying) {
+            ArenaPlayer* p = findPlayer(id);
+            clearBody(*p);
+            p->respawnTick = tickCount + respawnDelay;
+        }
+        if (!eaten.empty()) {
+            for (const SnakeSegment& s : eaten)
+                if (cell(s.x, s.y) == foodCell) cell(s.x, s.y) = emptyCell;
+            foods.erase(std::remove_if(foods.begin(), foods.end(), [this](const sf::Vector2i& f) { return cell(f.x, f.y) != foodCell; }),
+                        foods.end());
+        }
+
+        for (ArenaPlayer& p : players) {
+            if (!p.alive && tickCount >= p.respawnTick) spawn(p);
+        }
+        while (foods.size() < targetFood()) {
+            sf::Vector2i free;
+            if (!randomFreeCell(free)) break;
+            cell(free.x, free.y) = foodCell;
+            foods.push_back(free);
+        }
+    }
+
+    std::vector<ArenaPlayer> players;
+    std::vector<sf::Vector2i> foods;
+
+private:
+    std::uint16_t& cell(int x, int y) { return cells[static_cast<std::size_t>(y) * cols + x]; }
+    std::uint16_t cell(int x, int y) const { return cells[static_cast<std::size_t>(y) * cols + x]; }
+
+    void reindex() {
+        slotById.clear();
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (players[i].id >= slotById.size()) slotById.resize(players[i].id + 1, -1);
+            slotById[players[i].id] = static_cast<int>(i);
+        }
+    }
+
+    void kill(ArenaPlayer& p) {
+        if (!p.alive) return;
+        p.alive = false;
+        dying.push_back(p.id);
+    }
+
+    // Only the cells still marked as this snake's: a head that lost its
+    // cell to another snake never got it.
+    void clearBody(ArenaPlayer& p) {
+        const std::uint16_t mark = static_cast<std::uint16_t>(p.id + 1);
+        for (const SnakeSegment& s : p.body)
+            if (cell(s.x, s.y) == mark) cell(s.x, s.y) = emptyCell;
+        p.body.clear();
+    }
+
+    size_t targetFood() const { return players.size() / 2 + 1; }
+
+    bool randomFreeCell(sf::Vector2i& free) {
+        for (int tries = 0; tries < 64; ++tries) {
+            int x = rng.below(cols), y = rng.below(rows);
+            if (cell(x, y) == emptyCell) {
+                free = sf::Vector2i(x, y);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Needs a free cell with two free cells ahead; tries again next tick
+    // when the board is too crowded.
+    void spawn(ArenaPlayer& p) {
+        const Direction dirs[4] = { Up, Down, Left, Right };
+        for (int tries = 0; tries < 16; ++tries) {
+            sf::Vector2i free;
+            if (!randomFreeCell(free)) return;
+            Direction dir = dirs[rng.below(4)];
+            SnakeSegment start(free.x, free.y);
+            SnakeSegment a = stepFrom(start, dir);
+            SnakeSegment b = stepFrom(a, dir);
+            if (cell(a.x, a.y) == wallCell || ownerAt(a.x, a.y) >= 0 || cell(b.x, b.y) == wallCell || ownerAt(b.x, b.y) >= 0)
+                continue;
+            p.body.assign(1, start);
+            p.dir = p.nextDir = dir;
+            p.alive = true;
+            p.score = 0;
+            cell(start.x, start.y) = static_cast<std::uint16_t>(p.id + 1);
+            return;
+        }
+    }
+
+    int cols;
+    int rows;
+    std::vector<std::uint16_t> cells;
+    std::vector<int> slotById;  // index into players, -1 for unused ids
+    std::vector<SnakeSegment> eaten;
+    std::vector<std::uint16_t> dying;
+    GameRng rng;
+    std::uint32_t tickCount = 0;
+    std::uint32_t joinCount = 0;
+};
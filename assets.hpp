@@ -0,0 +1,170 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "archive.hpp"
+
+// --- Asynchronous asset manager ---
+// Reads and decodes assets on a small worker pool so the window can show a
+// loading screen right away. Workers only produce CPU-side objects (raw
+// bytes, sf::SoundBuffer, sf::Image); anything that needs the GPU, such as
+// building textures, is done by the main thread once an asset is ready.
+//
+// When an archive is given, assets are looked up in it by file name first
+// and decoded straight from the mapping; loose files are the fallback.
+class AssetManager {
+public:
+    explicit AssetManager(const AssetArchive* archive = nullptr, unsigned int workerCount = 2) : archive(archive) {
+        for (unsigned int i = 0; i < workerCount; ++i)
+            workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ~AssetManager() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // Raw file contents, e.g. for sf::Font::loadFromMemory or
+    // sf::Music::openFromMemory. The bytes live as long as the manager.
+    void loadBytes(const std::string& key, const std::string& path) {
+        enqueue(key, [this, path](Asset& a) {
+            a.view = packed(path);
+            if (a.view) return true;
+            if (!readFile(path, a.bytes)) return false;
+            a.view.data = a.bytes.data();
+            a.view.size = a.bytes.size();
+            return true;
+        });
+    }
+
+    void loadSound(const std::string& key, const std::string& path) {
+        enqueue(key, [this, path](Asset& a) {
+            a.sound.reset(new sf::SoundBuffer());
+            MemoryView v = packed(path);
+            return v ? a.sound->loadFromMemory(v.data, v.size) : a.sound->loadFromFile(path);
+        });
+    }
+
+    void loadImage(const std::string& key, const std::string& path) {
+        enqueue(key, [this, path](Asset& a) {
+            MemoryView v = packed(path);
+            return v ? a.image.loadFromMemory(v.data, v.size) : a.image.loadFromFile(path);
+        });
+    }
+
+    size_t total() const { return assets.size(); }
+    size_t completed() const { return completedCount.load(); }
+    bool done() const { return completed() == total(); }
+    float progress() const { return total() ? static_cast<float>(completed()) / total() : 1.f; }
+
+    // True once the asset has finished loading, successfully or not.
+    bool isReady(const std::string& key) const {
+        auto it = assets.find(key);
+        return it != assets.end() && it->second->ready.load(std::memory_order_acquire);
+    }
+
+    // Accessors return nullptr (or an empty view) until the asset is ready,
+    // or if it failed.
+    MemoryView bytes(const std::string& key) const {
+        const Asset* a = finished(key);
+        return a ? a->view : MemoryView();
+    }
+
+    const sf::SoundBuffer* sound(const std::string& key) const {
+        const Asset* a = finished(key);
+        return a ? a->sound.get() : nullptr;
+    }
+
+    const sf::Image* image(const std::string& key) const {
+        const Asset* a = finished(key);
+        return a ? &a->image : nullptr;
+    }
+
+private:
+    struct Asset {
+        std::atomic<bool> ready{false};
+        bool ok = false;
+        MemoryView view;
+        std::vector<char> bytes;
+        std::unique_ptr<sf::SoundBuffer> sound;
+        sf::Image image;
+    };
+
+    struct Job {
+        Asset* asset;
+        std::function<bool(Asset&)> load;
+    };
+
+    static bool readFile(const std::string& path, std::vector<char>& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        std::streamsize size = file.tellg();
+        file.seekg(0);
+        out.resize(static_cast<size_t>(size));
+        return static_cast<bool>(file.read(out.data(), size));
+    }
+
+    void enqueue(const std::string& key, std::function<bool(Asset&)> load) {
+        std::unique_ptr<Asset>& slot = assets[key];
+        slot.reset(new Asset());
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            jobs.push_back(Job{slot.get(), load});
+        }
+        queueReady.notify_one();
+    }
+
+    MemoryView packed(const std::string& path) const {
+        return archive ? archive->find(path) : MemoryView();
+    }
+
+    const Asset* finished(const std::string& key) const {
+        auto it = assets.find(key);
+        if (it == assets.end() || !it->second->ready.load(std::memory_order_acquire)) return nullptr;
+        return it->second->ok ? it->second.get() : nullptr;
+    }
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) return;
+                job = jobs.front();
+                jobs.pop_front();
+            }
+            job.asset->ok = job.load(*job.asset);
+            job.asset->ready.store(true, std::memory_order_release);
+            completedCount.fetch_add(1);
+        }
+    }
+
+    const AssetArchive* archive;
+    std::map<std::string, std::unique_ptr<Asset>> assets;
+    std::deque<Job> jobs;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> completedCount{0};
+    bool stopping = false;
+};
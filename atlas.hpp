@@ -0,0 +1,279 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "game.hpp"
+
+// --- Sprite ids packed into the atlas ---
+enum SpriteId {
+    SPRITE_APPLE,
+    SPRITE_SNAKE_HEAD,  // faces Right, neck on the left edge
+    SPRITE_SNAKE_BODY,  // straight, joins the left and right edges
+    SPRITE_SNAKE_TAIL,  // joins the right edge, tip on the left
+    SPRITE_SNAKE_TURN,  // joins the left and bottom edges
+    SPRITE_WALL,
+    SPRITE_COUNT
+};
+
+const int atlasTileSize = 32;
+
+// --- Procedural sprite art ---
+// Used for every piece that has no image on disk, so the game always has a
+// complete skin. Pieces are drawn at atlasTileSize and scaled down on draw.
+inline sf::Color shadeBand(float distFromCenter, float halfWidth) {
+    if (distFromCenter > halfWidth) return sf::Color::Transparent;
+    if (distFromCenter > halfWidth - 2.f) return sf::Color(0, 70, 0);
+    if (distFromCenter < 4.f) return sf::Color(0, 140, 0);
+    return sf::Color(0, 100, 0);
+}
+
+inline sf::Image makeSnakePiece(SpriteId id) {
+    const float t = static_cast<float>(atlasTileSize);
+    const float c = t / 2.f;
+    const float half = t / 2.f - 3.f;
+    sf::Image img;
+    img.create(atlasTileSize, atlasTileSize, sf::Color::Transparent);
+    for (int y = 0; y < atlasTileSize; ++y) {
+        for (int x = 0; x < atlasTileSize; ++x) {
+            float px = x + 0.5f, py = y + 0.5f;
+            sf::Color color = sf::Color::Transparent;
+            switch (id) {
+                case SPRITE_SNAKE_BODY:
+                    color = shadeBand(std::fabs(py - c), half);
+                    break;
+                case SPRITE_SNAKE_TAIL: {
+                    float taper = 3.f + (half - 3.f) * (px / t);
+                    color = shadeBand(std::fabs(py - c), taper);
+                    break;
+                }
+                case SPRITE_SNAKE_TURN: {
+                    float d = std::hypot(px, py - t);
+                    color = shadeBand(std::fabs(d - c), half);
+                    break;
+                }
+                case SPRITE_SNAKE_HEAD: {
+                    float d = px <= c ? std::fabs(py - c) : std::hypot(px - c, py - c);
+                    color = shadeBand(d, half);
+                    float ex = px - (c + 5.f);
+                    float eyeTop = std::hypot(ex, py - (c - 6.f));
+                    float eyeBottom = std::hypot(ex, py - (c + 6.f));
+                    float eye = std::min(eyeTop, eyeBottom);
+                    if (eye < 1.5f) color = sf::Color::Black;
+                    else if (eye < 3.5f) color = sf::Color::White;
+                    break;
+                }
+                default:
+                    break;
+            }
+            img.setPixel(x, y, color);
+        }
+    }
+    return img;
+}
+
+inline sf::Image makeWallTile() {
+    sf::Image img;
+    img.create(atlasTileSize, atlasTileSize, sf::Color(100, 100, 100));
+    for (int y = 0; y < atlasTileSize; ++y) {
+        for (int x = 0; x < atlasTileSize; ++x) {
+            int row = y / 8;
+            int offset = (row % 2) * 8;
+            if (y % 8 == 7 || (x + offset) % 16 == 15)
+                img.setPixel(x, y, sf::Color(80, 80, 80));
+            else if (y % 8 == 0)
+                img.setPixel(x, y, sf::Color(120, 120, 120));
+        }
+    }
+    return img;
+}
+
+inline sf::Image makeFallbackApple() {
+    sf::Image img;
+    img.create(atlasTileSize, atlasTileSize, sf::Color::Transparent);
+    const float c = atlasTileSize / 2.f;
+    for (int y = 0; y < atlasTileSize; ++y)
+        for (int x = 0; x < atlasTileSize; ++x)
+            if (std::hypot(x + 0.5f - c, y + 0.5f - c) <= c - 1.f)
+                img.setPixel(x, y, sf::Color::Red);
+    return img;
+}
+
+// --- Texture atlas ---
+// Shelf-packs every sprite into one texture at load time so the whole board
+// can be drawn with a single texture bind.
+class TextureAtlas {
+public:
+    void add(SpriteId id, const sf::Image& image) {
+        pending.push_back(Entry{id, image});
+    }
+
+    bool build(unsigned int maxWidth = 512) {
+        const unsigned int padding = 2;
+        std::vector<Entry*> order;
+        for (auto& e : pending) order.push_back(&e);
+        std::sort(order.begin(), order.end(), [](const Entry* a, const Entry* b) {
+            return a->image.getSize().y > b->image.getSize().y;
+        });
+
+        unsigned int x = padding, y = padding, shelfHeight = 0, usedWidth = 0;
+        std::vector<sf::Vector2u> positions(pending.size());
+        for (Entry* e : order) {
+            sf::Vector2u size = e->image.getSize();
+            if (x + size.x + padding > maxWidth && x > padding) {
+                x = padding;
+                y += shelfHeight + padding;
+                shelfHeight = 0;
+            }
+            positions[e - pending.data()] = sf::Vector2u(x, y);
+            x += size.x + padding;
+            usedWidth = std::max(usedWidth, x);
+            shelfHeight = std::max(shelfHeight, size.y);
+        }
+
+        sf::Image sheet;
+        sheet.create(usedWidth, y + shelfHeight + padding, sf::Color::Transparent);
+        for (size_t i = 0; i < pending.size(); ++i) {
+            sheet.copy(pending[i].image, positions[i].x, positions[i].y);
+            sf::Vector2u size = pending[i].image.getSize();
+            rects[pending[i].id] = sf::IntRect(positions[i].x, positions[i].y, size.x, size.y);
+        }
+        pending.clear();
+
+        if (!texture.loadFromImage(sheet)) return false;
+        texture.setSmooth(true);
+        return true;
+    }
+
+    const sf::Texture& getTexture() const { return texture; }
+    sf::IntRect getRect(SpriteId id) const { return rects[id]; }
+
+private:
+    struct Entry {
+        SpriteId id;
+        sf::Image image;
+    };
+    std::vector<Entry> pending;
+    sf::IntRect rects[SPRITE_COUNT];
+    sf::Texture texture;
+};
+
+// Fills the atlas with the apple image (if loaded), an optional snake skin
+// strip (head, body, tail, turn side by side, square tiles) and generated
+// art for anything missing.
+inline bool buildGameAtlas(TextureAtlas& atlas, const sf::Image* apple, const sf::Image* snakeSkin) {
+    atlas.add(SPRITE_APPLE, apple ? *apple : makeFallbackApple());
+    const SpriteId pieces[] = { SPRITE_SNAKE_HEAD, SPRITE_SNAKE_BODY, SPRITE_SNAKE_TAIL, SPRITE_SNAKE_TURN };
+    for (int i = 0; i < 4; ++i) {
+        unsigned int tile = snakeSkin ? snakeSkin->getSize().y : 0;
+        if (tile > 0 && snakeSkin->getSize().x >= tile * 4) {
+            sf::Image piece;
+            piece.create(tile, tile);
+            piece.copy(*snakeSkin, 0, 0, sf::IntRect(i * tile, 0, tile, tile));
+            atlas.add(pieces[i], piece);
+        } else {
+            atlas.add(pieces[i], makeSnakePiece(pieces[i]));
+        }
+    }
+    atlas.add(SPRITE_WALL, makeWallTile());
+    return atlas.build();
+}
+
+// --- Sprite batcher ---
+// Accumulates textured quads from one atlas and submits them in a single
+// draw call. Quads added before a truncate() point (e.g. static walls) are
+// kept across frames.
+class SpriteBatch : public sf::Drawable {
+public:
+    explicit SpriteBatch(const TextureAtlas& atlas) : atlas(atlas), vertices(sf::Quads) {}
+
+    // quarterTurns rotates the sprite clockwise in 90 degree steps.
+    void add(SpriteId id, float x, float y, float size, int quarterTurns = 0) {
+        sf::IntRect r = atlas.getRect(id);
+        const sf::Vector2f tex[4] = {
+            sf::Vector2f(r.left, r.top),
+            sf::Vector2f(r.left + r.width, r.top),
+            sf::Vector2f(r.left + r.width, r.top + r.height),
+            sf::Vector2f(r.left, r.top + r.height)
+        };
+        const sf::Vector2f pos[4] = {
+            sf::Vector2f(x, y),
+            sf::Vector2f(x + size, y),
+            sf::Vector2f(x + size, y + size),
+            sf::Vector2f(x, y + size)
+        };
+        for (int i = 0; i < 4; ++i)
+            vertices.append(sf::Vertex(pos[i], tex[(i - quarterTurns + 4) % 4]));
+    }
+
+    size_t quadCount() const { return vertices.getVertexCount() / 4; }
+    void truncate(size_t quads) { vertices.resize(quads * 4); }
+    void clear() { vertices.clear(); }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.texture = &atlas.getTexture();
+        target.draw(vertices, states);
+    }
+
+    const TextureAtlas& atlas;
+    sf::VertexArray vertices;
+};
+
+// --- Snake skinning ---
+// Quarter turns that rotate a sprite facing Right to face the given direction.
+inline int quarterTurnsFor(Direction d) {
+    switch (d) {
+        case Right: return 0;
+        case Down: return 1;
+        case Left: return 2;
+        default: return 3;
+    }
+}
+
+inline Direction directionTo(const SnakeSegment& from, const SnakeSegment& to) {
+    if (to.x > from.x) return Right;
+    if (to.x < from.x) return Left;
+    if (to.y > from.y) return Down;
+    return Up;
+}
+
+// Calls emit(segment, sprite, quarterTurns) for every piece of the snake.
+// Shared by every board renderer so they agree on the skin.
+template <typename Emit>
+inline void forEachSnakePiece(const Snake& snake, Emit emit) {
+    const size_t n = snake.body.size();
+    for (size_t i = 0; i < n; ++i) {
+        const SnakeSegment& seg = snake.body[i];
+        if (i == 0) {
+            Direction facing = n > 1 ? directionTo(snake.body[1], seg) : snake.dir;
+            emit(seg, SPRITE_SNAKE_HEAD, quarterTurnsFor(facing));
+        } else if (i == n - 1) {
+            emit(seg, SPRITE_SNAKE_TAIL, quarterTurnsFor(directionTo(seg, snake.body[i - 1])));
+        } else {
+            Direction a = directionTo(seg, snake.body[i - 1]);
+            Direction b = directionTo(seg, snake.body[i + 1]);
+            bool aHorizontal = (a == Left || a == Right);
+            bool bHorizontal = (b == Left || b == Right);
+            if (aHorizontal == bHorizontal) {
+                emit(seg, SPRITE_SNAKE_BODY, aHorizontal ? 0 : 1);
+            } else {
+                // The turn sprite joins Left and Down; rotate it onto {a, b}.
+                Direction h = aHorizontal ? a : b;
+                Direction v = aHorizontal ? b : a;
+                int turns = (h == Left) ? (v == Down ? 0 : 1) : (v == Up ? 2 : 3);
+                emit(seg, SPRITE_SNAKE_TURN, turns);
+            }
+        }
+    }
+}
+
+// Pieces cover the whole cell so neighbouring segments join up seamlessly.
+inline void addSnakeSprites(SpriteBatch& batch, const Snake& snake) {
+    const float size = static_cast<float>(blockSize);
+    forEachSnakePiece(snake, [&](const SnakeSegment& seg, SpriteId sprite, int turns) {
+        batch.add(sprite, static_cast<float>(seg.x * blockSize), static_cast<float>(seg.y * blockSize), size, turns);
+    });
+}
@@ -0,0 +1,412 @@
+// serpent_bench - microbenchmarks for the core game operations in game.hpp.
+//
+// Modelled on Google Benchmark: same flags, same console table, and the
+// same JSON schema (--benchmark_format=json / --benchmark_out=<file>), so
+// CI tooling such as compare.py can diff two runs directly.
+//
+//   serpent_bench [--benchmark_filter=<substr>] [--benchmark_min_time=<sec>]
+//                 [--benchmark_format=console|json] [--benchmark_out=<file>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arena.hpp"
+#include "game.hpp"
+#include "levelgen.hpp"
+
+// --- Minimal benchmark harness ---
+static double cpuSeconds() {
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// Wall and CPU time both stop while timing is paused.
+class BenchState {
+public:
+    BenchState(long long iterations, long long arg) : maxIterations(iterations), argument(arg) {}
+
+    long long range() const { return argument; }
+    long long iterations() const { return maxIterations; }
+
+    void pauseTiming() {
+        elapsed += Clock::now() - startTime;
+        cpuElapsed += cpuSeconds() - cpuStart;
+    }
+    void resumeTiming() {
+        startTime = Clock::now();
+        cpuStart = cpuSeconds();
+    }
+
+    struct Iterator {
+        BenchState* state;
+        long long remaining;
+        bool operator!=(const Iterator&) const {
+            if (remaining > 0) return true;
+            state->pauseTiming();
+            return false;
+        }
+        void operator++() { --remaining; }
+        // Non-trivial destructor keeps `for (auto _ : state)` free of unused-variable warnings.
+        struct Value { ~Value() {} };
+        Value operator*() const { return Value(); }
+    };
+    Iterator begin() { resumeTiming(); return Iterator{this, maxIterations}; }
+    Iterator end() { return Iterator{this, 0}; }
+
+    double seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+    double cpuTime() const { return cpuElapsed; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    long long maxIterations;
+    long long argument;
+    Clock::time_point startTime;
+    Clock::duration elapsed{};
+    double cpuStart = 0;
+    double cpuElapsed = 0;
+};
+
+struct BenchDef {
+    std::string name;
+    std::function<void(BenchState&)> fn;
+    std::vector<long long> args;
+};
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double realNs;
+    double cpuNs;
+};
+
+std::vector<BenchDef>& benchRegistry() {
+    static std::vector<BenchDef> registry;
+    return registry;
+}
+
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, std::function<void(BenchState&)> fn, std::vector<long long> args = {}) {
+        benchRegistry().push_back(BenchDef{name, fn, args});
+    }
+};
+
+#define SERPENT_BENCH_CONCAT2(a, b) a##b
+#define SERPENT_BENCH_CONCAT(a, b) SERPENT_BENCH_CONCAT2(a, b)
+#define BENCHMARK(fn, ...) \
+    static BenchRegistrar SERPENT_BENCH_CONCAT(benchReg_, __LINE__)(#fn, fn, ##__VA_ARGS__)
+
+template <typename T>
+inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Grows the iteration count until one run lasts at least minTime seconds,
+// exactly like Google Benchmark does.
+static BenchResult runOne(const std::string& name, const std::function<void(BenchState&)>& fn, long long arg, double minTime) {
+    long long iterations = 1;
+    for (;;) {
+        BenchState state(iterations, arg);
+        fn(state);
+        double real = state.seconds();
+        double cpu = state.cpuTime();
+        if (real >= minTime || iterations >= 1000000000LL) {
+            return BenchResult{name, iterations, real * 1e9 / iterations, cpu * 1e9 / iterations};
+        }
+        double multiplier = real > 0 ? minTime * 1.4 / real : 10.0;
+        if (multiplier > 10.0) multiplier = 10.0;
+        if (multiplier < 1.5) multiplier = 1.5;
+        iterations = static_cast<long long>(iterations * multiplier) + 1;
+    }
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void writeJson(std::ostream& out, const std::vector<BenchResult>& results) {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"serpent_bench\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"real_time\": " << r.realNs << ",\n";
+        out << "      \"cpu_time\": " << r.cpuNs << ",\n";
+        out << "      \"time_unit\": \"ns\"\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static void writeConsoleHeader(std::ostream& out) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-40s %14s %14s %12s\n", "Benchmark", "Time", "CPU", "Iterations");
+    out << line << std::string(82, '-') << "\n";
+}
+
+static void writeConsoleRow(std::ostream& out, const BenchResult& r) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-40s %11.1f ns %11.1f ns %12lld\n", r.name.c_str(), r.realNs, r.cpuNs, r.iterations);
+    out << line << std::flush;
+}
+
+// --- Fixtures ---
+// Lays a snake of the given length over the free cells in a boustrophedon
+// pattern so bodies stay inside the walls at any fill ratio.
+static Snake makeSnake(size_t length) {
+    Snake snake;
+    snake.body.clear();
+    snake.dir = Left;
+    int interiorCols = gridCols - 2;
+    for (size_t i = 0; i < length; ++i) {
+        int row = static_cast<int>(i / interiorCols);
+        int col = static_cast<int>(i % interiorCols);
+        if (row % 2 == 1) col = interiorCols - 1 - col;
+        snake.body.push_back(SnakeSegment(1 + col, 1 + row % (gridRows - 2)));
+    }
+    // Reverse so the head sits at the end of the path, away from the tail.
+    std::vector<SnakeSegment> reversed(snake.body.rbegin(), snake.body.rend());
+    snake.body = reversed;
+    return snake;
+}
+
+static const int freeCells = (gridCols - 2) * (gridRows - 2);
+
+// --- Benchmarks ---
+static void BM_SnakeMove(BenchState& state) {
+    Snake snake = makeSnake(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        snake.move();
+        doNotOptimize(snake.body.front());
+    }
+}
+BENCHMARK(BM_SnakeMove, {1, 16, 256, 1024});
+
+static void BM_SnakeGrow(BenchState& state) {
+    Snake snake = makeSnake(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        snake.grow();
+        snake.body.pop_back(); // keep the length fixed across iterations
+        doNotOptimize(snake.body.front());
+    }
+}
+BENCHMARK(BM_SnakeGrow, {1, 16, 256, 1024});
+
+static void BM_SnakeCheckCollision(BenchState& state) {
+    Snake snake = makeSnake(static_cast<size_t>(state.range()));
+    for (auto _ : state) {
+        bool hit = snake.checkCollision();
+        doNotOptimize(hit);
+    }
+}
+BENCHMARK(BM_SnakeCheckCollision, {1, 16, 256, 1024});
+
+// Argument is the snake fill ratio of the free board in percent.
+static void BM_GenerateFoodPosition(BenchState& state) {
+    setupWalls();
+    srand(42);
+    Snake snake = makeSnake(static_cast<size_t>(freeCells * state.range() / 100));
+    for (auto _ : state) {
+        sf::Vector2i pos = generateFoodPosition(snake);
+        doNotOptimize(pos);
+    }
+}
+BENCHMARK(BM_GenerateFoodPosition, {0, 25, 50, 75, 90, 99});
+
+static void BM_SetupWalls(BenchState& state) {
+    for (auto _ : state) {
+        setupWalls();
+        doNotOptimize(wallGrid);
+    }
+}
+BENCHMARK(BM_SetupWalls);
+
+// Full headless tick with a greedy autopilot steering towards the food.
+// Deaths restart the round outside the timed region.
+static void BM_GameTick(BenchState& state) {
+    setupWalls();
+    srand(42);
+    Snake snake;
+    sf::Vector2i food = generateFoodPosition(snake);
+    int score = 0;
+    for (auto _ : state) {
+        const SnakeSegment& head = snake.body.front();
+        if (food.x > head.x && snake.dir != Left) snake.dir = Right;
+        else if (food.x < head.x && snake.dir != Right) snake.dir = Left;
+        else if (food.y > head.y && snake.dir != Up) snake.dir = Down;
+        else if (food.y < head.y && snake.dir != Down) snake.dir = Up;
+
+        TickResult result = tickGame(snake, food, score);
+        doNotOptimize(result);
+        if (result == DIED) {
+            state.pauseTiming();
+            snake = Snake();
+            food = generateFoodPosition(snake);
+            score = 0;
+            state.resumeTiming();
+        }
+    }
+}
+BENCHMARK(BM_GameTick);
+
+// Argument is the board side length in cells.
+static void BM_GenerateLevelObstacles(BenchState& state) {
+    GeneratorSettings settings;
+    settings.cols = settings.rows = static_cast<int>(state.range());
+    settings.density = 0.2f;
+    for (auto _ : state) {
+        ++settings.seed;
+        Level level = generateLevel(settings);
+        doNotOptimize(level.wallBits.data());
+    }
+}
+BENCHMARK(BM_GenerateLevelObstacles, {64, 256, 1024});
+
+static void BM_GenerateLevelMaze(BenchState& state) {
+    GeneratorSettings settings;
+    settings.cols = settings.rows = static_cast<int>(state.range());
+    settings.style = MAZE;
+    settings.density = 0.9f;
+    for (auto _ : state) {
+        ++settings.seed;
+        Level level = generateLevel(settings);
+        doNotOptimize(level.wallBits.data());
+    }
+}
+BENCHMARK(BM_GenerateLevelMaze, {64, 256, 1024});
+
+// 1000 snakes on a 1024x1024 arena, each circling its own 2-row track of
+// 1022 cells so none of them dies. Argument is the snake length. A tick
+// does the same work at any length, but longer snakes spread their heads
+// and tails over more memory, so it still gets slower with length.
+static const int arenaSide = 1024;
+static const int arenaSnakes = 1000;
+static const int trackWidth = (arenaSide - 2) / 2;
+
+static SnakeSegment trackCell(int snake, int k) {
+    int x0 = 1 + (snake % 2) * trackWidth, y0 = 1 + (snake / 2) * 2;
+    return k < trackWidth ? SnakeSegment(x0 + k, y0) : SnakeSegment(x0 + 2 * trackWidth - 1 - k, y0 + 1);
+}
+
+static Direction trackDirection(int snake, const SnakeSegment& head) {
+    int x0 = 1 + (snake % 2) * trackWidth, y0 = 1 + (snake / 2) * 2;
+    if (head.y == y0) return head.x < x0 + trackWidth - 1 ? Right : Down;
+    return head.x > x0 ? Left : Up;
+}
+
+static Arena makeTrackArena(int length) {
+    Arena arena(arenaSide, arenaSide, 7);
+    for (int i = 0; i < arenaSnakes; ++i) {
+        int id = arena.addPlayer();
+        std::deque<SnakeSegment> body;
+        for (int k = length - 1; k >= 0; --k) body.push_back(trackCell(i, k));
+        arena.placeSnake(id, body, trackDirection(i, body.front()));
+    }
+    return arena;
+}
+
+static void BM_ArenaTick(BenchState& state) {
+    const int length = static_cast<int>(state.range());
+    // Apples on a track make snakes grow, at most one segment per tick;
+    // start over before one could outgrow its track.
+    const long long rebuildEvery = std::max(2 * trackWidth - length, 2);
+    Arena arena = makeTrackArena(length);
+    long long ticks = 0;
+    auto step = [&] {
+        for (size_t i = 0; i < arena.players.size(); ++i)
+            arena.setDirection(arena.players[i].id, trackDirection(static_cast<int>(i), arena.players[i].body.front()));
+        arena.tick();
+    };
+    for (auto _ : state) {
+        // The first tick on a fresh arena finds every head and tail out
+        // of cache, which a running server never does, so it stays
+        // untimed.
+        if (++ticks % rebuildEvery == 0) {
+            state.pauseTiming();
+            arena = makeTrackArena(length);
+            step();
+            ++ticks;
+            state.resumeTiming();
+        }
+        step();
+        doNotOptimize(arena.players.front().body.front());
+    }
+}
+BENCHMARK(BM_ArenaTick, {10, 100, 1000});
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string format = "console";
+    std::string outFile;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* prefix) -> const char* {
+            size_t n = std::string(prefix).size();
+            return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+        };
+        if (const char* v = value("--benchmark_filter=")) filter = v;
+        else if (const char* v = value("--benchmark_format=")) format = v;
+        else if (const char* v = value("--benchmark_out=")) outFile = v;
+        else if (const char* v = value("--benchmark_min_time=")) minTime = std::atof(v);
+        else {
+            std::cerr << "usage: serpent_bench [--benchmark_filter=<substr>] [--benchmark_min_time=<sec>]"
+                         " [--benchmark_format=console|json] [--benchmark_out=<file>]\n";
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    if (format == "console") writeConsoleHeader(std::cout);
+    for (const BenchDef& def : benchRegistry()) {
+        std::vector<long long> args = def.args.empty() ? std::vector<long long>{0} : def.args;
+        for (long long arg : args) {
+            std::string name = def.name;
+            if (!def.args.empty()) name += "/" + std::to_string(arg);
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+            results.push_back(runOne(name, def.fn, arg, minTime));
+            if (format == "console") writeConsoleRow(std::cout, results.back());
+        }
+    }
+
+    if (format == "json") writeJson(std::cout, results);
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        writeJson(out, results);
+    }
+    return 0;
+}
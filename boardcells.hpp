@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SFML/Config.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+#include "atlas.hpp"
+#include "game.hpp"
+
+// --- Board cell tracker ---
+// What each cell of the board shows, four bytes per cell in texture order:
+// sprite id + 1 (0 = floor), clockwise quarter turns, 255 when drawn inset
+// like walls and apples, 255. update() works out the snake's and food's
+// cells and lists the ones whose bytes changed, so a renderer only has to
+// touch those.
+class BoardCells {
+public:
+    // After a level change: every cell is rebuilt from wallGrid and every
+    // wall is listed as changed.
+    void reset() {
+        cols = gridCols;
+        rows = gridRows;
+        bytes.assign(static_cast<size_t>(cols) * rows * 4, 0);
+        marks.assign(static_cast<size_t>(cols) * rows, 0);
+        dynamic.clear();
+        changed.clear();
+        for (int i = 0; i < cols * rows; ++i) restore(i);
+    }
+
+    // Cells that held a piece last time and don't now go back to floor.
+    void update(const Snake& snake, sf::Vector2i food) {
+        ++frame;
+        std::vector<int> previous;
+        previous.swap(dynamic);
+        forEachSnakePiece(snake, [&](const SnakeSegment& seg, SpriteId sprite, int turns) {
+            if (contains(seg.x, seg.y)) place(seg.y * cols + seg.x, sprite, turns, false);
+        });
+        if (contains(food.x, food.y)) place(food.y * cols + food.x, SPRITE_APPLE, 0, true);
+        for (int index : previous)
+            if (marks[index] != frame) restore(index);
+    }
+
+    int getCols() const { return cols; }
+    int getRows() const { return rows; }
+    const sf::Uint8* data() const { return bytes.data(); }
+    const sf::Uint8* cell(int index) const { return &bytes[static_cast<size_t>(index) * 4]; }
+
+    // Changed since the last clearChanged(). A cell may appear twice.
+    const std::vector<int>& getChanged() const { return changed; }
+    void clearChanged() { changed.clear(); }
+
+private:
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < cols && y < rows; }
+
+    void place(int index, SpriteId sprite, int turns, bool inset) {
+        if (marks[index] != frame) {
+            marks[index] = frame;
+            dynamic.push_back(index);
+        }
+        write(index, static_cast<sf::Uint8>(sprite + 1), static_cast<sf::Uint8>(turns), inset);
+    }
+
+    void restore(int index) {
+        bool wall = wallGrid[index / cols][index % cols];
+        write(index, wall ? SPRITE_WALL + 1 : 0, 0, wall);
+    }
+
+    void write(int index, sf::Uint8 sprite, sf::Uint8 turns, bool inset) {
+        sf::Uint8* p = &bytes[static_cast<size_t>(index) * 4];
+        const sf::Uint8 b = inset ? 255 : 0;
+        if (p[0] == sprite && p[1] == turns && p[2] == b && p[3] == 255) return;
+        p[0] = sprite;
+        p[1] = turns;
+        p[2] = b;
+        p[3] = 255;
+        changed.push_back(index);
+    }
+
+    int cols = 0, rows = 0;
+    std::vector<sf::Uint8> bytes;
+    std::vector<unsigned> marks;  // frame a cell last got a piece
+    std::vector<int> dynamic;     // cells holding a piece this frame
+    std::vector<int> changed;
+    unsigned frame = 0;
+};
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <SFML/OpenGL.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define SERPENT_GLAPI __stdcall
+#else
+#define SERPENT_GLAPI
+#endif
+
+// --- Offscreen frame capture ---
+// Reads frames back from a RenderTexture and writes them as numbered PNGs
+// or as raw RGBA on stdout (for ffmpeg -f rawvideo -pix_fmt rgba).
+//
+// glReadPixels into a client pointer waits for the GPU to finish the frame.
+// Instead, each frame is read into one of two pixel-pack buffers and the
+// other one, filled a frame earlier and long since ready, is mapped and
+// handed on: the GPU renders frame N while frame N-1 is copied out. Drivers
+// without buffer objects get a plain copyToImage(). Encoding and writing run
+// on their own thread, a few frames behind.
+class FrameCapture {
+public:
+    enum Format { PNG_FILES, RAW_RGBA };
+
+    static constexpr size_t maxQueued = 4;
+
+    // dir is where PNG_FILES go; RAW_RGBA writes to stdout.
+    FrameCapture(unsigned int w, unsigned int h, Format format, const std::string& dir)
+        : width(w), height(h), format(format), dir(dir) {
+        if (format == RAW_RGBA) {
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        }
+        writer = std::thread([this] { writeLoop(); });
+    }
+
+    ~FrameCapture() { finish(); }
+
+    // Captures what target shows after display(). repeat is the number of
+    // output frames this image stands for; a tick held for several video
+    // frames is read back once.
+    void capture(sf::RenderTexture& target, unsigned int repeat) {
+        if (repeat == 0) return;
+        this->target = &target;
+        if (!target.setActive(true)) return;
+        if (!triedBuffers) initBuffers();
+        if (!buffered) {
+            sf::Image image = target.getTexture().copyToImage();
+            Frame frame = takeFrame();
+            frame.repeat = repeat;
+            std::memcpy(frame.pixels.data(), image.getPixelsPtr(), frame.pixels.size());
+            push(std::move(frame));
+            return;
+        }
+        gl.bindBuffer(packBuffer, pbo[current]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        pendingRepeat[current] = repeat;
+        current ^= 1;
+        if (pendingRepeat[current]) collect(current);
+        gl.bindBuffer(packBuffer, 0);
+    }
+
+    // Writes out the frame still in flight and waits for the writer. The
+    // target must still exist.
+    void finish() {
+        if (buffered && pbo[0] && target && target->setActive(true)) {
+            if (pendingRepeat[current ^ 1]) {
+                collect(current ^ 1);
+                gl.bindBuffer(packBuffer, 0);
+            }
+            gl.deleteBuffers(2, pbo);
+            pbo[0] = pbo[1] = 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        queueChanged.notify_all();
+        writer.join();
+    }
+
+    bool usesBuffers() const { return buffered; }
+    unsigned long long getFramesWritten() const { return framesWritten; }
+    bool ok() const { return !failed; }
+
+private:
+    struct Frame {
+        std::vector<sf::Uint8> pixels;
+        unsigned int repeat = 0;
+    };
+
+    // OpenGL 1.5 buffer objects; SFML doesn't wrap them, so they're looked
+    // up at run time.
+    static constexpr GLenum packBuffer = 0x88EB;  // GL_PIXEL_PACK_BUFFER
+    static constexpr GLenum streamRead = 0x88E1;  // GL_STREAM_READ
+    static constexpr GLenum readOnly = 0x88B8;    // GL_READ_ONLY
+    struct BufferFunctions {
+        void (SERPENT_GLAPI* genBuffers)(GLsizei, GLuint*) = nullptr;
+        void (SERPENT_GLAPI* deleteBuffers)(GLsizei, const GLuint*) = nullptr;
+        void (SERPENT_GLAPI* bindBuffer)(GLenum, GLuint) = nullptr;
+        void (SERPENT_GLAPI* bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum) = nullptr;
+        void* (SERPENT_GLAPI* mapBuffer)(GLenum, GLenum) = nullptr;
+        GLboolean (SERPENT_GLAPI* unmapBuffer)(GLenum) = nullptr;
+    };
+
+    template <typename Fn>
+    static void load(Fn& fn, const char* name) {
+        fn = reinterpret_cast<Fn>(sf::Context::getFunction(name));
+    }
+
+    void initBuffers() {
+        triedBuffers = true;
+        load(gl.genBuffers, "glGenBuffers");
+        load(gl.deleteBuffers, "glDeleteBuffers");
+        load(gl.bindBuffer, "glBindBuffer");
+        load(gl.bufferData, "glBufferData");
+        load(gl.mapBuffer, "glMapBuffer");
+        load(gl.unmapBuffer, "glUnmapBuffer");
+        if (!gl.genBuffers || !gl.deleteBuffers || !gl.bindBuffer || !gl.bufferData || !gl.mapBuffer || !gl.unmapBuffer) return;
+        gl.genBuffers(2, pbo);
+        for (GLuint buffer : pbo) {
+            gl.bindBuffer(packBuffer, buffer);
+            gl.bufferData(packBuffer, static_cast<std::ptrdiff_t>(width) * height * 4, nullptr, streamRead);
+        }
+        gl.bindBuffer(packBuffer, 0);
+        buffered = true;
+    }
+
+    // Maps a filled buffer and queues its pixels, turned top row first.
+    void collect(int index) {
+        gl.bindBuffer(packBuffer, pbo[index]);
+        const sf::Uint8* mapped = static_cast<const sf::Uint8*>(gl.mapBuffer(packBuffer, readOnly));
+        if (mapped) {
+            Frame frame = takeFrame();
+            frame.repeat = pendingRepeat[index];
+            const size_t row = static_cast<size_t>(width) * 4;
+            for (unsigned int y = 0; y < height; ++y)
+                std::memcpy(&frame.pixels[y * row], mapped + (height - 1 - y) * row, row);
+            gl.unmapBuffer(packBuffer);
+            push(std::move(frame));
+        } else {
+            failed = true;
+        }
+        pendingRepeat[index] = 0;
+    }
+
+    // A recycled frame buffer, so a long export doesn't allocate per frame.
+    Frame takeFrame() {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        Frame frame;
+        if (!spare.empty()) {
+            frame = std::move(spare.back());
+            spare.pop_back();
+        }
+        frame.pixels.resize(static_cast<size_t>(width) * height * 4);
+        return frame;
+    }
+
+    // Blocks while the writer is maxQueued frames behind.
+    void push(Frame frame) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueChanged.wait(lock, [this] { return queue.size() < maxQueued; });
+        queue.push_back(std::move(frame));
+        queueChanged.notify_all();
+    }
+
+    void writeLoop() {
+        for (;;) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                frame = std::move(queue.front());
+                queue.pop_front();
+            }
+            queueChanged.notify_all();
+            write(frame);
+            std::lock_guard<std::mutex> lock(queueMutex);
+            spare.push_back(std::move(frame));
+        }
+    }
+
+    void write(const Frame& frame) {
+        if (format == RAW_RGBA) {
+            for (unsigned int i = 0; i < frame.repeat; ++i)
+                if (std::fwrite(frame.pixels.data(), 1, frame.pixels.size(), stdout) != frame.pixels.size()) failed = true;
+            std::fflush(stdout);
+            framesWritten += frame.repeat;
+            return;
+        }
+        // Repeats of a frame are copies of the file, not encoded again.
+        sf::Image image;
+        image.create(width, height, frame.pixels.data());
+        const std::string first = framePath(framesWritten++);
+        if (!image.saveToFile(first)) failed = true;
+        std::error_code ec;
+        for (unsigned int i = 1; i < frame.repeat; ++i)
+            if (!std::filesystem::copy_file(first, framePath(framesWritten++), std::filesystem::copy_options::overwrite_existing, ec))
+                failed = true;
+    }
+
+    std::string framePath(unsigned long long n) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06llu.png", n);
+        return (std::filesystem::path(dir) / name).string();
+    }
+
+    unsigned int width, height;
+    Format format;
+    std::string dir;
+
+    BufferFunctions gl;
+    GLuint pbo[2] = {0, 0};
+    unsigned int pendingRepeat[2] = {0, 0};
+    int current = 0;
+    bool triedBuffers = false;
+    bool buffered = false;
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<Frame> queue;
+    std::vector<Frame> spare;
+    bool stopping = false;
+    std::thread writer;
+    std::atomic<unsigned long long> framesWritten{0};
+    std::atomic<bool> failed{false};
+    sf::RenderTexture* target = nullptr;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "atlas.hpp"
+#include "boardcells.hpp"
+#include "game.hpp"
+
+// --- Dirty-rectangle board ---
+// For software OpenGL (VM kiosks, Mesa llvmpipe), where a frame costs what
+// it fills. The last frame is kept in a window-sized RenderTexture and only
+// the cells BoardCells reports as changed are repainted: usually the new
+// head, the old head, the old and new tail and the food. Each is covered
+// with a floor patch and its piece drawn on top, and the window gets the
+// whole board back with one blit. The HUD is drawn over it as before.
+// The blit is a fixed cost (about 3 ms at 800x600 on one llvmpipe core), so
+// this pays off on big or crowded boards, not on the classic one.
+class DirtyBoard : public sf::Drawable {
+public:
+    explicit DirtyBoard(const TextureAtlas& atlas) : pieces(atlas), patches(sf::Quads) {}
+
+    bool create(unsigned int w, unsigned int h, sf::Color background) {
+        floorColor = background;
+        if (!canvas.create(w, h)) return false;
+        sprite.setTexture(canvas.getTexture(), true);
+        return true;
+    }
+
+    // After a level or atlas change; the next update() repaints everything.
+    void reset(const sf::View& boardView) {
+        view = boardView;
+        board.reset();
+        repaintAll = true;
+    }
+
+    void update(const Snake& snake, sf::Vector2i food) {
+        board.update(snake, food);
+        const std::vector<int>& changed = board.getChanged();
+        lastRedrawn = changed.size();
+        if (changed.empty() && !repaintAll) return;
+
+        // board.reset() listed every wall, so a repaint is a clear plus the
+        // usual pass over changed cells.
+        if (repaintAll) canvas.clear(floorColor);
+        repaintAll = false;
+        patches.clear();
+        pieces.clear();
+        const int cols = board.getCols();
+        const float size = static_cast<float>(blockSize);
+        for (int index : changed) {
+            float x = static_cast<float>(index % cols * blockSize), y = static_cast<float>(index / cols * blockSize);
+            patches.append(sf::Vertex(sf::Vector2f(x, y), floorColor));
+            patches.append(sf::Vertex(sf::Vector2f(x + size, y), floorColor));
+            patches.append(sf::Vertex(sf::Vector2f(x + size, y + size), floorColor));
+            patches.append(sf::Vertex(sf::Vector2f(x, y + size), floorColor));
+            const sf::Uint8* cell = board.cell(index);
+            if (cell[0]) pieces.add(static_cast<SpriteId>(cell[0] - 1), x, y, cell[2] ? size - 2 : size, cell[1]);
+        }
+        board.clearChanged();
+
+        canvas.setView(view);
+        canvas.draw(patches);
+        canvas.draw(pieces);
+        canvas.display();
+    }
+
+    // Cells repainted by the last update().
+    size_t lastRedrawCount() const { return lastRedrawn; }
+
+private:
+    // The canvas is opaque, and a blend costs as much as the copy itself in
+    // a software rasterizer.
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.blendMode = sf::BlendNone;
+        target.draw(sprite, states);
+    }
+
+    BoardCells board;
+    SpriteBatch pieces;
+    sf::VertexArray patches;
+    sf::RenderTexture canvas;
+    sf::Sprite sprite;
+    sf::View view;
+    sf::Color floorColor;
+    bool repaintAll = true;
+    size_t lastRedrawn = 0;
+};
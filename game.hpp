@@ -0,0 +1,154 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+#include <cstdlib>
+
+const int blockSize = 20;
+const int width = 800;
+const int height = 600;
+
+// --- Snake segment struct ---
+struct SnakeSegment {
+    int x, y;
+    SnakeSegment(int x, int y) : x(x), y(y) {}
+};
+
+enum Direction { Up, Down, Left, Right };
+enum GameState { MENU, PLAYING, PAUSED, GAMEOVER, HIGHSCORES };
+enum TickResult { MOVED, ATE, DIED };
+
+// --- Wall grid and setup ---
+// The grid defaults to the window size; loading a level resizes it.
+inline int gridCols = width / blockSize;
+inline int gridRows = height / blockSize;
+inline std::vector<std::vector<bool>> wallGrid(gridRows, std::vector<bool>(gridCols, false));
+
+// --- Per-level rules ---
+struct LevelRules {
+    int baseSpeed = 5;   // ticks per second at score 0
+    int speedStep = 5;   // +1 tick per second every speedStep points
+    int foodScore = 1;   // points per apple
+};
+inline LevelRules levelRules;
+inline SnakeSegment levelSpawn(width / (2 * blockSize), height / (2 * blockSize));
+inline Direction levelDirection = Right;
+
+// --- Snake class ---
+class Snake {
+public:
+    std::vector<SnakeSegment> body;
+    Direction dir;
+
+    // A new snake starts at the current level's spawn point.
+    Snake() {
+        body.push_back(levelSpawn);
+        dir = levelDirection;
+    }
+
+    Snake(SnakeSegment spawn, Direction startDir) {
+        body.push_back(spawn);
+        dir = startDir;
+    }
+
+    void move() {
+        SnakeSegment head = body.front();
+        switch (dir) {
+            case Up: head.y--; break;
+            case Down: head.y++; break;
+            case Left: head.x--; break;
+            case Right: head.x++; break;
+        }
+        body.insert(body.begin(), head);
+        body.pop_back();
+    }
+
+    void grow() {
+        SnakeSegment head = body.front();
+        switch (dir) {
+            case Up: head.y--; break;
+            case Down: head.y++; break;
+            case Left: head.x--; break;
+            case Right: head.x++; break;
+        }
+        body.insert(body.begin(), head);
+    }
+
+    bool checkCollision() {
+        SnakeSegment head = body.front();
+        if (head.x < 0 || head.y < 0 || head.x >= gridCols || head.y >= gridRows)
+            return true;
+        for (size_t i = 1; i < body.size(); i++) {
+            if (body[i].x == head.x && body[i].y == head.y)
+                return true;
+        }
+        return false;
+    }
+};
+
+// --- Wall setup ---
+// Classic board: the window-sized grid with a solid border.
+inline void setupWalls() {
+    gridCols = width / blockSize;
+    gridRows = height / blockSize;
+    wallGrid.assign(gridRows, std::vector<bool>(gridCols, false));
+    levelRules = LevelRules();
+    levelSpawn = SnakeSegment(gridCols / 2, gridRows / 2);
+    levelDirection = Right;
+    for (int i = 0; i < gridCols; ++i) {
+        wallGrid[0][i] = true;
+        wallGrid[gridRows-1][i] = true;
+    }
+    for (int i = 0; i < gridRows; ++i) {
+        wallGrid[i][0] = true;
+        wallGrid[i][gridCols-1] = true;
+    }
+}
+
+// --- Food generation ---
+inline sf::Vector2i generateFoodPosition(const Snake& snake) {
+    sf::Vector2i pos;
+    bool invalid;
+    do {
+        invalid = false;
+        pos.x = rand() % gridCols;
+        pos.y = rand() % gridRows;
+        if (wallGrid[pos.y][pos.x]) {
+            invalid = true;
+            continue;
+        }
+        for (const auto& segment : snake.body) {
+            if (segment.x == pos.x && segment.y == pos.y) {
+                invalid = true;
+                break;
+            }
+        }
+    } while (invalid);
+    return pos;
+}
+
+// --- One game tick: move, eat, collide ---
+// Shared by the windowed loop and headless callers (benchmarks).
+inline TickResult tickGame(Snake& snake, sf::Vector2i& food, int& score) {
+    SnakeSegment nextHead = snake.body.front();
+    switch (snake.dir) {
+        case Up: nextHead.y--; break;
+        case Down: nextHead.y++; break;
+        case Left: nextHead.x--; break;
+        case Right: nextHead.x++; break;
+    }
+    if (nextHead.x < 0 || nextHead.y < 0 || nextHead.x >= gridCols || nextHead.y >= gridRows || wallGrid[nextHead.y][nextHead.x])
+        return DIED;
+
+    TickResult result = MOVED;
+    snake.move();
+    if (snake.body.front().x == food.x && snake.body.front().y == food.y) {
+        snake.grow();
+        food = generateFoodPosition(snake);
+        score += levelRules.foodScore;
+        result = ATE;
+    }
+    if (snake.checkCollision())
+        return DIED;
+    return result;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "atlas.hpp"
+#include "boardcells.hpp"
+#include "game.hpp"
+
+// --- Shader board renderer ---
+// Draws walls, snake and food as a single quad. The board lives in a small
+// texture with one texel per cell (the bytes of BoardCells); a fragment
+// shader finds each pixel's cell and samples the atlas. Only cells that
+// changed since the last frame are uploaded, so a frame costs the same
+// whatever the snake's length or the board's size. Needs GLSL; without it
+// the game keeps the SpriteBatch path.
+class ShaderBoard : public sf::Drawable {
+public:
+    static bool isAvailable() { return sf::Shader::isAvailable(); }
+
+    bool create() { return shader.loadFromMemory(vertexSource, fragmentSource); }
+
+    // After a level or atlas change: repaints every cell from wallGrid.
+    bool reset(const TextureAtlas& atlas) {
+        board.reset();
+        board.clearChanged();
+        cols = board.getCols();
+        rows = board.getRows();
+        if (!cells.create(cols, rows)) return false;
+        cells.update(board.data());
+
+        const sf::Vector2u atlasSize = atlas.getTexture().getSize();
+        sf::Glsl::Vec4 rects[SPRITE_COUNT];
+        for (int i = 0; i < SPRITE_COUNT; ++i) {
+            sf::IntRect r = atlas.getRect(static_cast<SpriteId>(i));
+            rects[i] = sf::Glsl::Vec4(static_cast<float>(r.left) / atlasSize.x, static_cast<float>(r.top) / atlasSize.y,
+                                      static_cast<float>(r.width) / atlasSize.x, static_cast<float>(r.height) / atlasSize.y);
+        }
+        shader.setUniform("cells", cells);
+        shader.setUniform("atlas", atlas.getTexture());
+        shader.setUniform("gridSize", sf::Glsl::Vec2(static_cast<float>(cols), static_cast<float>(rows)));
+        shader.setUniform("inset", static_cast<float>(blockSize - 2) / blockSize);
+        shader.setUniformArray("sprites", rects, SPRITE_COUNT);
+
+        const float w = static_cast<float>(cols * blockSize), h = static_cast<float>(rows * blockSize);
+        quad[0] = sf::Vertex(sf::Vector2f(0, 0), sf::Vector2f(0, 0));
+        quad[1] = sf::Vertex(sf::Vector2f(w, 0), sf::Vector2f(static_cast<float>(cols), 0));
+        quad[2] = sf::Vertex(sf::Vector2f(w, h), sf::Vector2f(static_cast<float>(cols), static_cast<float>(rows)));
+        quad[3] = sf::Vertex(sf::Vector2f(0, h), sf::Vector2f(0, static_cast<float>(rows)));
+        return true;
+    }
+
+    // Brings the texture up to date with the snake and food.
+    void update(const Snake& snake, sf::Vector2i food) {
+        board.update(snake, food);
+        upload();
+    }
+
+    // Cells uploaded by the last update().
+    size_t lastUploadCount() const { return lastUploaded; }
+
+private:
+    // A handful of cells go up one texel each; after a respawn or a big
+    // growth the rows they span go up in one call instead.
+    static constexpr size_t maxSingleUploads = 32;
+
+    void upload() {
+        const std::vector<int>& changed = board.getChanged();
+        lastUploaded = changed.size();
+        if (changed.size() <= maxSingleUploads) {
+            for (int index : changed)
+                cells.update(board.cell(index), 1, 1, index % cols, index / cols);
+        } else {
+            int top = rows, bottom = 0;
+            for (int index : changed) {
+                top = std::min(top, index / cols);
+                bottom = std::max(bottom, index / cols);
+            }
+            cells.update(board.cell(top * cols), cols, bottom - top + 1, 0, top);
+        }
+        board.clearChanged();
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.shader = &shader;
+        target.draw(quad, 4, sf::Quads, states);
+    }
+
+    // Texture coordinates are in cells; the vertex shader passes them on
+    // untouched instead of through SFML's texture matrix.
+    static constexpr const char* vertexSource = R"(
+void main() {
+    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+    gl_TexCoord[0] = gl_MultiTexCoord0;
+    gl_FrontColor = gl_Color;
+}
+)";
+
+    static constexpr const char* fragmentSource = R"(
+uniform sampler2D cells;
+uniform sampler2D atlas;
+uniform vec2 gridSize;
+uniform float inset;
+uniform vec4 sprites[6];
+
+void main() {
+    vec2 pos = gl_TexCoord[0].xy;
+    vec2 cell = floor(pos);
+    vec4 texel = texture2D(cells, (cell + 0.5) / gridSize);
+    int id = int(texel.r * 255.0 + 0.5);
+    if (id == 0) discard;
+    vec2 local = pos - cell;
+    if (texel.b > 0.5) {
+        if (local.x > inset || local.y > inset) discard;
+        local /= inset;
+    }
+    // Clockwise quarter turns, as SpriteBatch::add rotates its corners.
+    float turns = floor(texel.g * 255.0 + 0.5);
+    for (int i = 0; i < 3; ++i)
+        if (float(i) < turns) local = vec2(local.y, 1.0 - local.x);
+    vec4 rect = sprites[id - 1];
+    gl_FragColor = gl_Color * texture2D(atlas, rect.xy + local * rect.zw);
+}
+)";
+
+    sf::Shader shader;
+    sf::Texture cells;
+    sf::Vertex quad[4];
+    BoardCells board;  // CPU copy of the cell texture
+    int cols = 0, rows = 0;
+    size_t lastUploaded = 0;
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// --- Double-buffered asset slot ---
+// A loader thread builds the next version of an asset off to the side and
+// publishes it; the main thread swaps it in between ticks. The front object
+// is only ever touched by the main thread, so rendering never sees a
+// half-loaded asset.
+template <typename T>
+class AssetSlot {
+public:
+    // Loader side. A newer publish replaces a pending one not yet swapped.
+    void publish(std::unique_ptr<T> next) {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending = std::move(next);
+    }
+
+    // Main thread. Returns true when a new version became current. Never
+    // waits on the loader: if it is mid-publish, the swap happens next time.
+    bool swap() {
+        std::unique_lock<std::mutex> lock(pendingMutex, std::try_to_lock);
+        if (!lock || !pending) return false;
+        front = std::move(pending);
+        return true;
+    }
+
+    const T* get() const { return front.get(); }
+
+private:
+    std::mutex pendingMutex;
+    std::unique_ptr<T> pending;
+    std::unique_ptr<T> front;
+};
+
+// --- Directory watcher ---
+// Calls onChange(path) on its own thread for every file written or moved
+// into one of the watched directories (not recursive). Uses inotify on
+// Linux and polls modification times every half second elsewhere. Bursts
+// of events for the same file (editors often write in several steps) are
+// merged into one call.
+class FileWatcher {
+public:
+    using Callback = std::function<void(const std::string&)>;
+
+    FileWatcher(const std::vector<std::string>& dirs, Callback onChange) : dirs(dirs), onChange(onChange) {
+        worker = std::thread([this] { run(); });
+    }
+
+    ~FileWatcher() {
+        stopping.store(true);
+        worker.join();
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+private:
+    static constexpr std::chrono::milliseconds settleTime{100};
+
+    void dispatch(std::set<std::string>& changed) {
+        for (const std::string& path : changed) onChange(path);
+        changed.clear();
+    }
+
+#ifdef __linux__
+    void run() {
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) return;
+        std::map<int, std::string> watches;
+        for (const std::string& dir : dirs) {
+            int wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd >= 0) watches[wd] = dir;
+        }
+
+        std::set<std::string> changed;
+        alignas(inotify_event) char buffer[4096];
+        while (!stopping.load()) {
+            // Short timeout so the destructor never waits long, and so a
+            // burst has settled before it is dispatched.
+            pollfd pfd = { fd, POLLIN, 0 };
+            int ready = poll(&pfd, 1, static_cast<int>(settleTime.count()));
+            if (ready <= 0) {
+                dispatch(changed);
+                continue;
+            }
+            ssize_t len;
+            while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + len;) {
+                    const inotify_event* ev = reinterpret_cast<const inotify_event*>(p);
+                    auto it = watches.find(ev->wd);
+                    if (it != watches.end() && ev->len > 0 && !(ev->mask & IN_ISDIR))
+                        changed.insert(it->second + "/" + ev->name);
+                    p += sizeof(inotify_event) + ev->len;
+                }
+            }
+        }
+        close(fd);
+    }
+#else
+    void run() {
+        namespace fs = std::filesystem;
+        std::map<std::string, fs::file_time_type> stamps;
+        auto scan = [&](std::set<std::string>* changed) {
+            std::error_code ec;
+            for (const std::string& dir : dirs) {
+                for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                    if (!it->is_regular_file(ec)) continue;
+                    std::string path = it->path().string();
+                    fs::file_time_type stamp = it->last_write_time(ec);
+                    auto known = stamps.find(path);
+                    if (known == stamps.end() || known->second != stamp) {
+                        if (changed) changed->insert(path);
+                        stamps[path] = stamp;
+                    }
+                }
+            }
+        };
+        scan(nullptr);
+
+        std::set<std::string> changed;
+        int ticks = 0;
+        while (!stopping.load()) {
+            std::this_thread::sleep_for(settleTime);
+            if (++ticks < 5) continue;
+            ticks = 0;
+            // Rescan until nothing moved, so half-written files are skipped.
+            scan(&changed);
+            if (!changed.empty()) {
+                std::set<std::string> more;
+                do {
+                    std::this_thread::sleep_for(settleTime);
+                    more.clear();
+                    scan(&more);
+                    changed.insert(more.begin(), more.end());
+                } while (!more.empty() && !stopping.load());
+                dispatch(changed);
+            }
+        }
+    }
+#endif
+
+    std::vector<std::string> dirs;
+    Callback onChange;
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
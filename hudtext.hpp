@@ -0,0 +1,173 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// --- Glyph quads ---
+// Writes one glyph with its pen at (x, baseline), as sf::Text lays it out.
+// Glyphs sit one pixel apart in the font texture, so the quad takes that
+// padding in too. Glyphs without pixels (spaces) get an empty quad.
+inline void setGlyphQuad(sf::Vertex* quad, const sf::Glyph& g, float x, float baseline, sf::Color color) {
+    if (g.bounds.width <= 0) {
+        for (int i = 0; i < 4; ++i) quad[i] = sf::Vertex(sf::Vector2f(x, baseline), color);
+        return;
+    }
+    const float padding = 1.f;
+    const float left = x + g.bounds.left - padding, right = x + g.bounds.left + g.bounds.width + padding;
+    const float top = baseline + g.bounds.top - padding, bottom = baseline + g.bounds.top + g.bounds.height + padding;
+    const float u1 = g.textureRect.left - padding, u2 = g.textureRect.left + g.textureRect.width + padding;
+    const float v1 = g.textureRect.top - padding, v2 = g.textureRect.top + g.textureRect.height + padding;
+    quad[0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1));
+    quad[1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1));
+    quad[2] = sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2));
+    quad[3] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2));
+}
+
+// --- HUD text ---
+// One line of fixed labels and numbers, such as "Score: 12   High Score: 40".
+// sf::Text rebuilds and lays out every glyph whenever its string is set.
+// This line looks up its glyphs once, when the parts are added, and keeps
+// one quad per character in a vertex array that never changes size.
+// Setting a number rewrites only the digits that changed; the rest of the
+// line moves only when the width changes, i.e. when the digit count or the
+// advance of a digit does. An unchanged number costs a compare.
+//
+// Parts are added up front. Setting numbers allocates nothing and lays
+// out nothing new. Kerning is not applied; the HUD font is monospaced.
+class HudText : public sf::Drawable, public sf::Transformable {
+public:
+    HudText(const sf::Font& font, unsigned int characterSize, sf::Color color)
+        : font(font), characterSize(characterSize), color(color), vertices(sf::Quads) {
+        for (char c = '0'; c <= '9'; ++c) cache(c);
+    }
+
+    void addLabel(const std::string& text) {
+        Part part;
+        part.firstSlot = slotCount();
+        part.slots = text.size();
+        part.label = text;
+        for (char c : text) cache(c);
+        parts.push_back(part);
+        vertices.resize(slotCount() * 4);
+        layout();
+    }
+
+    // A number of up to maxDigits digits, starting at 0. Returns its field
+    // index for setNumber().
+    size_t addNumber(unsigned int maxDigits) {
+        Part part;
+        part.firstSlot = slotCount();
+        part.slots = std::max(maxDigits, 1u);
+        part.digits.assign(part.slots, '0');
+        part.digitX.assign(part.slots, 0.f);
+        part.digitCount = 1;
+        parts.push_back(part);
+        vertices.resize(slotCount() * 4);
+        layout();
+        return parts.size() - 1;
+    }
+
+    // Negative values show as 0 and values too long for the field keep
+    // their lowest digits. Returns true when the line's bounds changed.
+    bool setNumber(size_t field, int value) {
+        Part& part = parts[field];
+        value = std::max(value, 0);
+        if (value == part.value) return false;
+        part.value = value;
+
+        char digits[16];
+        size_t count = 0;
+        for (unsigned int v = static_cast<unsigned int>(value); count == 0 || (v > 0 && count < part.slots); v /= 10)
+            digits[count++] = static_cast<char>('0' + v % 10);
+        std::reverse(digits, digits + count);
+
+        bool resized = count != part.digitCount;
+        for (size_t i = 0; i < count && !resized; ++i)
+            resized = glyph(digits[i]).advance != glyph(part.digits[i]).advance;
+        if (resized) {
+            std::copy(digits, digits + count, part.digits.begin());
+            part.digitCount = count;
+            layout();
+            return true;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (digits[i] == part.digits[i]) continue;
+            part.digits[i] = digits[i];
+            place(part.firstSlot + i, part.digitX[i], digits[i]);
+        }
+        return false;
+    }
+
+    // Like sf::Text::getLocalBounds(), but the height covers every cached
+    // glyph, so the line doesn't bob as digits change.
+    sf::FloatRect getLocalBounds() const { return bounds; }
+
+private:
+    struct Part {
+        size_t firstSlot = 0, slots = 0;
+        std::string label;           // empty for a number
+        std::vector<char> digits;    // a number's digits, most significant first
+        std::vector<float> digitX;   // pen position of each digit slot
+        size_t digitCount = 0;
+        int value = 0;
+    };
+
+    size_t slotCount() const { return parts.empty() ? 0 : parts.back().firstSlot + parts.back().slots; }
+
+    const sf::Glyph& glyph(char c) const { return glyphs[static_cast<unsigned char>(c) & 0x7F]; }
+
+    void cache(char c) {
+        unsigned char i = static_cast<unsigned char>(c) & 0x7F;
+        if (cached[i]) return;
+        glyphs[i] = font.getGlyph(static_cast<sf::Uint32>(i), characterSize, false);
+        cached[i] = true;
+        top = std::min(top, glyphs[i].bounds.top);
+        bottom = std::max(bottom, glyphs[i].bounds.top + glyphs[i].bounds.height);
+    }
+
+    void place(size_t slot, float x, char c) {
+        setGlyphQuad(&vertices[slot * 4], glyph(c), x, static_cast<float>(characterSize), color);
+    }
+
+    // Places every part from the left; unused digit slots become empty quads.
+    void layout() {
+        float x = 0;
+        for (Part& part : parts) {
+            if (part.digits.empty()) {
+                for (size_t i = 0; i < part.label.size(); ++i) {
+                    place(part.firstSlot + i, x, part.label[i]);
+                    x += glyph(part.label[i]).advance;
+                }
+                continue;
+            }
+            for (size_t i = 0; i < part.slots; ++i) {
+                part.digitX[i] = x;
+                if (i < part.digitCount) {
+                    place(part.firstSlot + i, x, part.digits[i]);
+                    x += glyph(part.digits[i]).advance;
+                } else {
+                    place(part.firstSlot + i, x, ' ');
+                }
+            }
+        }
+        bounds = sf::FloatRect(0, characterSize + top, x, bottom - top);
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        states.transform *= getTransform();
+        states.texture = &font.getTexture(characterSize);
+        target.draw(vertices, states);
+    }
+
+    const sf::Font& font;
+    unsigned int characterSize;
+    sf::Color color;
+    sf::Glyph glyphs[128];
+    bool cached[128] = {};
+    float top = 0, bottom = 0;
+    std::vector<Part> parts;
+    sf::VertexArray vertices;
+    sf::FloatRect bounds;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// --- Cached screen layer ---
+// Renders a static screen once into an off-screen texture and blits it with
+// a single sprite afterwards. Call invalidate() when something on the screen
+// changes; the next update() re-renders it.
+class CachedLayer : public sf::Drawable {
+public:
+    bool create(unsigned int w, unsigned int h, sf::Color background) {
+        clearColor = background;
+        dirty = true;
+        if (!texture.create(w, h)) return false;
+        sprite.setTexture(texture.getTexture(), true);
+        return true;
+    }
+
+    void invalidate() { dirty = true; }
+    bool isDirty() const { return dirty; }
+
+    template <typename RenderFn>
+    void update(RenderFn render) {
+        if (!dirty) return;
+        // Cleared with the opaque screen background so anti-aliased text
+        // edges blend against the right colour instead of transparency.
+        texture.clear(clearColor);
+        render(texture);
+        texture.display();
+        dirty = false;
+    }
+
+    // Draws over the cached image without clearing it, e.g. to repaint only
+    // what changed. Does nothing while a full update() is due.
+    template <typename RenderFn>
+    void patch(RenderFn render) {
+        if (dirty) return;
+        render(texture);
+        texture.display();
+    }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        target.draw(sprite, states);
+    }
+
+    sf::RenderTexture texture;
+    sf::Sprite sprite;
+    sf::Color clearColor;
+    bool dirty = true;
+};
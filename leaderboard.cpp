@@ -0,0 +1,380 @@
+// serpent_leaderboard: score service for the game, spoken to over HTTP.
+//
+//   serpent_leaderboard [--port 8090] [--data scores.txt]
+//   serpent_leaderboard --bench [--seconds 5] [--clients 8]
+//
+// Requests are listed in leaderboard.hpp. Scores live in memory; with
+// --data every improvement is appended to the file and replayed on start.
+// --bench starts a server on a spare port and measures requests per second
+// from local clients over keep-alive connections and through
+// LeaderboardClient (one connection per request, as the game does).
+
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "leaderboard.hpp"
+
+// --- HTTP server ---
+// One thread, one selector. Connections are kept alive unless the client
+// asks otherwise (HTTP/1.0 without keep-alive, or "Connection: close", as
+// LeaderboardClient sends), and pipelined requests are answered in order.
+// select() can't watch descriptors past FD_SETSIZE, so at most
+// maxConnections are open at once; the rest wait in the listen backlog.
+//
+// Sockets are non-blocking. Responses queue per connection and go out as
+// the socket takes them, so a client that stops reading only holds up
+// itself; once maxPendingOutput bytes are waiting for it, it is dropped.
+class LeaderboardServer {
+public:
+    static constexpr std::size_t maxConnections = 512;
+    static constexpr std::size_t maxRequestSize = 8192;
+    static constexpr std::size_t maxPendingOutput = 256 * 1024;
+
+    explicit LeaderboardServer(const std::string& dataPath = "") : dataPath(dataPath) {}
+
+    bool listen(unsigned short port, const sf::IpAddress& address = sf::IpAddress::Any) {
+        if (!dataPath.empty()) {
+            std::ifstream in(dataPath);
+            std::string name;
+            std::int64_t score;
+            while (in >> name >> score)
+                if (isValidPlayerName(name)) table.submit(name, score);
+            log.open(dataPath, std::ios::app);
+        }
+        if (listener.listen(port, address) != sf::Socket::Done) return false;
+        listener.setBlocking(false);
+        selector.add(listener);
+        return true;
+    }
+
+    void run(const std::atomic<bool>& stop) {
+        while (!stop.load()) {
+            // The selector only reports readability, so while a response
+            // is still queued the loop comes back every millisecond to
+            // send more of it.
+            bool queued = false;
+            for (const auto& c : connections) queued = queued || !c->output.empty();
+            bool ready = selector.wait(sf::milliseconds(queued ? 1 : 100));
+            if (!ready && !queued) continue;
+            if (ready && selector.isReady(listener)) acceptAll();
+            for (size_t i = 0; i < connections.size();) {
+                Connection& c = *connections[i];
+                bool open = c.closing || !ready || !selector.isReady(*c.socket) || serve(c);
+                if (!open || !flush(c)) {
+                    selector.remove(*c.socket);
+                    connections.erase(connections.begin() + i);
+                } else {
+                    ++i;
+                }
+            }
+        }
+    }
+
+    std::uint64_t getRequests() const { return requests; }
+    std::size_t getEntries() const { return table.size(); }
+
+private:
+    struct Connection {
+        std::unique_ptr<sf::TcpSocket> socket;
+        std::string input;
+        std::string output;    // responses not yet sent
+        bool closing = false;  // close once output is sent
+    };
+
+    void acceptAll() {
+        while (connections.size() < maxConnections) {
+            std::unique_ptr<Connection> c(new Connection);
+            c->socket.reset(new sf::TcpSocket);
+            if (listener.accept(*c->socket) != sf::Socket::Done) break;
+            c->socket->setBlocking(false);
+            selector.add(*c->socket);
+            connections.push_back(std::move(c));
+        }
+    }
+
+    // Reads what arrived and queues an answer to every complete request.
+    // False closes the connection.
+    bool serve(Connection& c) {
+        char buffer[4096];
+        std::size_t received = 0;
+        sf::Socket::Status status = c.socket->receive(buffer, sizeof(buffer), received);
+        if (status == sf::Socket::NotReady) return true;
+        if (status != sf::Socket::Done) return false;
+        c.input.append(buffer, received);
+
+        bool keepAlive = true;
+        for (;;) {
+            std::size_t headerEnd = c.input.find("\r\n\r\n");
+            if (headerEnd == std::string::npos) {
+                if (c.input.size() > maxRequestSize) return false;
+                break;
+            }
+            std::size_t bodyLength = std::strtoul(headerValue(c.input, headerEnd, "content-length").c_str(), nullptr, 10);
+            if (bodyLength > maxRequestSize) return false;
+            if (c.input.size() < headerEnd + 4 + bodyLength) break;
+
+            std::string head = c.input.substr(0, headerEnd);
+            std::string body = c.input.substr(headerEnd + 4, bodyLength);
+            c.input.erase(0, headerEnd + 4 + bodyLength);
+
+            std::string connection = headerValue(head, head.size(), "connection");
+            std::size_t requestLine = std::min(head.find("\r\n"), head.size());
+            bool http10 = requestLine >= 8 && head.compare(requestLine - 8, 8, "HTTP/1.0") == 0;
+            keepAlive = http10 ? connection == "keep-alive" || connection == "Keep-Alive" : connection != "close" && connection != "Close";
+            c.output += respond(head, body, keepAlive);
+            ++requests;
+            if (!keepAlive) break;
+        }
+        if (!keepAlive) {
+            // Nothing more is read; only the queued output remains.
+            c.closing = true;
+            selector.remove(*c.socket);
+        }
+        return true;
+    }
+
+    // Sends as much of the queued output as the socket takes right now.
+    // False closes the connection: it is finished, gone or too far behind.
+    bool flush(Connection& c) {
+        if (!c.output.empty()) {
+            std::size_t sent = 0;
+            sf::Socket::Status status = c.socket->send(c.output.data(), c.output.size(), sent);
+            if (status == sf::Socket::Done) c.output.clear();
+            else if (status == sf::Socket::Partial || status == sf::Socket::NotReady) c.output.erase(0, sent);
+            else return false;
+        }
+        return c.output.size() <= maxPendingOutput && !(c.closing && c.output.empty());
+    }
+
+    // Case-insensitive lookup in the header block [0, end).
+    static std::string headerValue(const std::string& text, std::size_t end, const char* name) {
+        const std::size_t nameLength = std::strlen(name);
+        for (std::size_t line = text.find("\r\n"); line != std::string::npos && line < end; line = text.find("\r\n", line + 2)) {
+            std::size_t start = line + 2;
+            if (start + nameLength + 1 > end || text[start + nameLength] != ':') continue;
+            bool match = true;
+            for (std::size_t k = 0; k < nameLength && match; ++k)
+                match = std::tolower(static_cast<unsigned char>(text[start + k])) == name[k];
+            if (!match) continue;
+            std::size_t value = text.find_first_not_of(' ', start + nameLength + 1);
+            std::size_t stop = std::min(text.find("\r\n", start), end);
+            return value < stop ? text.substr(value, stop - value) : std::string();
+        }
+        return std::string();
+    }
+
+    // Value of key in "a=1&b=2".
+    static std::string param(const std::string& query, const char* key) {
+        const std::size_t keyLength = std::strlen(key);
+        for (std::size_t pos = 0; pos < query.size();) {
+            std::size_t amp = query.find('&', pos);
+            if (amp == std::string::npos) amp = query.size();
+            if (amp - pos > keyLength && query.compare(pos, keyLength, key) == 0 && query[pos + keyLength] == '=')
+                return query.substr(pos + keyLength + 1, amp - pos - keyLength - 1);
+            pos = amp + 1;
+        }
+        return std::string();
+    }
+
+    static std::string reply(int status, const char* reason, const std::string& body, bool keepAlive) {
+        return "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\nContent-Type: text/plain\r\nContent-Length: " +
+               std::to_string(body.size()) + (keepAlive ? "\r\n\r\n" : "\r\nConnection: close\r\n\r\n") + body;
+    }
+
+    // Submits and logs an improvement; the caller flushes the log.
+    std::size_t record(const std::string& name, std::int64_t score) {
+        const ScoreEntry* before = table.find(name);
+        bool improves = !before || score > before->score;
+        std::size_t rank = table.submit(name, score);
+        if (improves && log.is_open()) log << name << ' ' << score << '\n';
+        return rank;
+    }
+
+    std::string respond(const std::string& head, const std::string& body, bool keepAlive) {
+        std::size_t space = head.find(' ');
+        std::size_t uriEnd = head.find(' ', space + 1);
+        if (space == std::string::npos || uriEnd == std::string::npos) return reply(400, "Bad Request", "", keepAlive);
+        std::string method = head.substr(0, space);
+        std::string uri = head.substr(space + 1, uriEnd - space - 1);
+        std::size_t q = uri.find('?');
+        std::string path = uri.substr(0, q);
+        std::string query = q == std::string::npos ? std::string() : uri.substr(q + 1);
+
+        if (method == "POST" && path == "/scores") {
+            std::string name = param(body, "name");
+            std::string score = param(body, "score");
+            if (!isValidPlayerName(name) || score.empty()) return reply(400, "Bad Request", "", keepAlive);
+            std::size_t rank = record(name, std::strtoll(score.c_str(), nullptr, 10));
+            if (log.is_open()) log.flush();
+            return reply(200, "OK", "rank=" + std::to_string(rank) + "\n", keepAlive);
+        }
+        if (method == "POST" && path == "/scores/batch") {
+            std::istringstream in(body);
+            std::string name, text;
+            std::int64_t score;
+            while (in >> name >> score) {
+                std::size_t rank = isValidPlayerName(name) ? record(name, score) : 0;
+                text += std::to_string(rank) + "\n";
+            }
+            if (log.is_open()) log.flush();
+            return reply(200, "OK", text, keepAlive);
+        }
+        if (method == "GET" && path == "/top") {
+            std::size_t count = std::min<std::size_t>(std::strtoul(param(query, "n").c_str(), nullptr, 10), 100);
+            std::string text;
+            std::size_t rank = 1;
+            for (const ScoreEntry& e : table.top(count ? count : 10))
+                text += std::to_string(rank++) + " " + e.name + " " + std::to_string(e.score) + "\n";
+            return reply(200, "OK", text, keepAlive);
+        }
+        if (method == "GET" && path == "/rank") {
+            std::string name = param(query, "name");
+            if (!name.empty()) {
+                const ScoreEntry* e = table.find(name);
+                if (!e) return reply(404, "Not Found", "", keepAlive);
+                return reply(200, "OK", "rank=" + std::to_string(table.rankOf(name)) + " score=" + std::to_string(e->score) + "\n", keepAlive);
+            }
+            std::string score = param(query, "score");
+            if (score.empty()) return reply(400, "Bad Request", "", keepAlive);
+            return reply(200, "OK", "rank=" + std::to_string(table.rankForScore(std::strtoll(score.c_str(), nullptr, 10))) + "\n", keepAlive);
+        }
+        return reply(404, "Not Found", "", keepAlive);
+    }
+
+    std::string dataPath;
+    std::ofstream log;
+    ScoreTable table;
+    sf::TcpListener listener;
+    sf::SocketSelector selector;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::uint64_t requests = 0;
+};
+
+// --- Load test ---
+// A mix of 70% submissions, 20% rank lookups and 10% top-10 pages from
+// 5000 player names, as raw HTTP/1.1 on kept-alive connections.
+static void runKeepAliveClient(unsigned short port, int seed, const std::atomic<bool>& stop, std::atomic<std::uint64_t>& done) {
+    sf::TcpSocket socket;
+    if (socket.connect(sf::IpAddress::LocalHost, port) != sf::Socket::Done) return;
+    std::minstd_rand rng(static_cast<unsigned>(seed));
+    std::string pending;
+    char buffer[4096];
+    std::uint64_t count = 0;
+    while (!stop.load()) {
+        std::string name = "p" + std::to_string(rng() % 5000);
+        unsigned kind = rng() % 10;
+        std::string request;
+        if (kind < 7) {
+            std::string body = "name=" + name + "&score=" + std::to_string(rng() % 100000);
+            request = "POST /scores HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        } else if (kind < 9) {
+            request = "GET /rank?name=" + name + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        } else {
+            request = "GET /top?n=10 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        }
+        if (socket.send(request.data(), request.size()) != sf::Socket::Done) return;
+        // Read one whole response: headers, then Content-Length bytes.
+        for (;;) {
+            std::size_t headerEnd = pending.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                std::size_t lengthAt = pending.find("Content-Length: ");
+                std::size_t length = lengthAt < headerEnd ? std::strtoul(pending.c_str() + lengthAt + 16, nullptr, 10) : 0;
+                if (pending.size() >= headerEnd + 4 + length) {
+                    pending.erase(0, headerEnd + 4 + length);
+                    break;
+                }
+            }
+            std::size_t received = 0;
+            if (socket.receive(buffer, sizeof(buffer), received) != sf::Socket::Done) return;
+            pending.append(buffer, received);
+        }
+        ++count;
+    }
+    done += count;
+}
+
+static void runHttpClient(unsigned short port, int seed, const std::atomic<bool>& stop, std::atomic<std::uint64_t>& done) {
+    LeaderboardClient client("127.0.0.1", port);
+    std::minstd_rand rng(static_cast<unsigned>(seed));
+    std::uint64_t count = 0;
+    while (!stop.load()) {
+        if (client.submit("h" + std::to_string(rng() % 5000), rng() % 100000) == 0) return;
+        ++count;
+    }
+    done += count;
+}
+
+static void runBench(float seconds, int clients) {
+    const unsigned short port = 8190;
+    LeaderboardServer server;
+    if (!server.listen(port, sf::IpAddress::LocalHost)) {
+        std::cerr << "cannot listen on TCP port " << port << "\n";
+        return;
+    }
+    std::atomic<bool> stopServer(false);
+    std::thread serverThread([&] { server.run(stopServer); });
+
+    std::cout << std::fixed << std::setprecision(0);
+    for (int mode = 0; mode < 2; ++mode) {
+        std::atomic<bool> stop(false);
+        std::atomic<std::uint64_t> done(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < clients; ++i) {
+            if (mode == 0) threads.emplace_back([&, i] { runKeepAliveClient(port, i + 1, stop, done); });
+            else threads.emplace_back([&, i] { runHttpClient(port, i + 1, stop, done); });
+        }
+        sf::sleep(sf::seconds(seconds));
+        stop.store(true);
+        for (auto& t : threads) t.join();
+        std::cout << (mode == 0 ? "keep-alive " : "one-shot   ") << clients << " clients: " << done.load() / seconds
+                  << " requests/s\n";
+    }
+    stopServer.store(true);
+    serverThread.join();
+    std::cout << server.getEntries() << " names on the board\n";
+}
+
+int main(int argc, char** argv) {
+    int port = 8090;
+    std::string data;
+    bool bench = false;
+    float seconds = 5;
+    int clients = 8;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--bench") == 0) bench = true;
+        else if (std::strcmp(argv[i], "--port") == 0 && hasValue) port = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--data") == 0 && hasValue) data = argv[++i];
+        else if (std::strcmp(argv[i], "--seconds") == 0 && hasValue) seconds = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--clients") == 0 && hasValue) clients = std::atoi(argv[++i]);
+        else {
+            std::cerr << "unknown option " << argv[i] << "\n";
+            return 1;
+        }
+    }
+    if (bench) {
+        runBench(seconds, clients);
+        return 0;
+    }
+
+    LeaderboardServer server(data);
+    if (port <= 0 || port > 65535 || !server.listen(static_cast<unsigned short>(port))) {
+        std::cerr << "cannot listen on TCP port " << port << "\n";
+        return 1;
+    }
+    std::cout << "leaderboard on http://localhost:" << port << "/ with " << server.getEntries() << " names\n";
+    std::atomic<bool> stop(false);
+    server.run(stop);
+    return 0;
+}
@@ -0,0 +1,500 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// --- Order-statistics skip list ---
+// The leaderboard, best first: higher score, then earlier submission. Every
+// forward link also stores how many entries it jumps over, so an entry's
+// rank is the sum of the widths along the search path to it. Insert, erase
+// and rank lookups are O(log n) expected, a top-N page O(log n + N).
+// Each name keeps its best score only.
+struct ScoreEntry {
+    std::string name;
+    std::int64_t score = 0;
+    std::uint64_t order = 0;  // submission number; breaks ties
+};
+
+class ScoreTable {
+public:
+    static constexpr int maxLevel = 24;  // plenty for 4^24 entries
+
+    ScoreTable() : nodes(1) { nodes[0].links.resize(maxLevel); }
+
+    // Returns the name's rank (1 = best) after the submission. A score no
+    // better than the name's current best changes nothing.
+    std::size_t submit(const std::string& name, std::int64_t score) {
+        auto known = byName.find(name);
+        if (known != byName.end()) {
+            if (score <= nodes[known->second].entry.score) return rankOf(name);
+            erase(known->second);
+        }
+        ScoreEntry entry;
+        entry.name = name;
+        entry.score = score;
+        entry.order = ++submissions;
+        std::size_t rank = 0;
+        byName[name] = insert(entry, rank);
+        return rank;
+    }
+
+    // 1-based rank of the name, 0 if it has no score.
+    std::size_t rankOf(const std::string& name) const {
+        auto known = byName.find(name);
+        if (known == byName.end()) return 0;
+        const ScoreEntry& key = nodes[known->second].entry;
+        std::size_t rank = 0;
+        int x = 0;
+        for (int i = level - 1; i >= 0; --i) {
+            while (nodes[x].links[i].next && !before(key, nodes[nodes[x].links[i].next].entry)) {
+                rank += nodes[x].links[i].width;
+                x = nodes[x].links[i].next;
+            }
+        }
+        return rank;
+    }
+
+    const ScoreEntry* find(const std::string& name) const {
+        auto known = byName.find(name);
+        return known == byName.end() ? nullptr : &nodes[known->second].entry;
+    }
+
+    // The rank a new submission of this score would get.
+    std::size_t rankForScore(std::int64_t score) const {
+        std::size_t rank = 0;
+        int x = 0;
+        for (int i = level - 1; i >= 0; --i) {
+            while (nodes[x].links[i].next && nodes[nodes[x].links[i].next].entry.score >= score) {
+                rank += nodes[x].links[i].width;
+                x = nodes[x].links[i].next;
+            }
+        }
+        return rank + 1;
+    }
+
+    // Up to count entries starting at firstRank (1-based).
+    std::vector<ScoreEntry> range(std::size_t firstRank, std::size_t count) const {
+        std::vector<ScoreEntry> out;
+        if (firstRank < 1 || firstRank > length) return out;
+        // Walk to the entry just before firstRank, then along the bottom level.
+        std::size_t traversed = 0;
+        int x = 0;
+        for (int i = level - 1; i >= 0; --i) {
+            while (nodes[x].links[i].next && traversed + nodes[x].links[i].width < firstRank) {
+                traversed += nodes[x].links[i].width;
+                x = nodes[x].links[i].next;
+            }
+        }
+        for (x = nodes[x].links[0].next; x && out.size() < count; x = nodes[x].links[0].next)
+            out.push_back(nodes[x].entry);
+        return out;
+    }
+
+    std::vector<ScoreEntry> top(std::size_t count) const { return range(1, count); }
+    std::size_t size() const { return length; }
+
+private:
+    struct Link {
+        int next = 0;             // node index, 0 = end of list
+        std::uint32_t width = 0;  // entries jumped over, the target included
+    };
+
+    struct Node {
+        ScoreEntry entry;
+        std::vector<Link> links;
+    };
+
+    static bool before(const ScoreEntry& a, const ScoreEntry& b) {
+        return a.score > b.score || (a.score == b.score && a.order < b.order);
+    }
+
+    int randomLevel() {
+        int l = 1;
+        while (l < maxLevel && (rng() & 3) == 0) ++l;
+        return l;
+    }
+
+    // Finds, per level, the last node before key and its rank.
+    void search(const ScoreEntry& key, int* update, std::size_t* rankAt) const {
+        std::size_t rank = 0;
+        int x = 0;
+        for (int i = level - 1; i >= 0; --i) {
+            while (nodes[x].links[i].next && before(nodes[nodes[x].links[i].next].entry, key)) {
+                rank += nodes[x].links[i].width;
+                x = nodes[x].links[i].next;
+            }
+            update[i] = x;
+            rankAt[i] = rank;
+        }
+    }
+
+    int insert(const ScoreEntry& entry, std::size_t& rank) {
+        int update[maxLevel];
+        std::size_t rankAt[maxLevel];
+        search(entry, update, rankAt);
+
+        int newLevel = randomLevel();
+        for (int i = level; i < newLevel; ++i) {
+            update[i] = 0;
+            rankAt[i] = 0;
+            nodes[0].links[i].width = static_cast<std::uint32_t>(length);
+        }
+        level = std::max(level, newLevel);
+
+        int n;
+        if (!freeNodes.empty()) {
+            n = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            n = static_cast<int>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[n].entry = entry;
+        nodes[n].links.assign(newLevel, Link());
+        for (int i = 0; i < newLevel; ++i) {
+            Link& prev = nodes[update[i]].links[i];
+            std::uint32_t skipped = static_cast<std::uint32_t>(rankAt[0] - rankAt[i]);
+            nodes[n].links[i].next = prev.next;
+            nodes[n].links[i].width = prev.width - skipped;
+            prev.next = n;
+            prev.width = skipped + 1;
+        }
+        for (int i = newLevel; i < level; ++i) nodes[update[i]].links[i].width++;
+        ++length;
+        rank = rankAt[0] + 1;
+        return n;
+    }
+
+    void erase(int n) {
+        int update[maxLevel];
+        std::size_t rankAt[maxLevel];
+        search(nodes[n].entry, update, rankAt);
+        for (int i = 0; i < level; ++i) {
+            Link& prev = nodes[update[i]].links[i];
+            if (prev.next == n) {
+                prev.width += nodes[n].links[i].width - 1;
+                prev.next = nodes[n].links[i].next;
+            } else {
+                prev.width--;
+            }
+        }
+        while (level > 1 && !nodes[0].links[level - 1].next) --level;
+        --length;
+        nodes[n].links.clear();
+        freeNodes.push_back(n);
+    }
+
+    std::vector<Node> nodes;  // nodes[0] is the head
+    std::vector<int> freeNodes;
+    std::unordered_map<std::string, int> byName;
+    std::size_t length = 0;
+    int level = 1;
+    std::uint64_t submissions = 0;
+    std::minstd_rand rng{12345};
+};
+
+// Names travel unescaped in URLs and form bodies, so they are restricted
+// to letters, digits, '_' and '-'.
+inline bool isValidPlayerName(const std::string& name) {
+    if (name.empty() || name.size() > 16) return false;
+    for (char c : name)
+        if (!(std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-')) return false;
+    return true;
+}
+
+// --- Leaderboard client ---
+// Talks to serpent_leaderboard over HTTP/1.0. Each call is one request on a
+// fresh connection, and the whole exchange, connect to last byte, is bounded
+// by its timeout. sf::Http only bounds the connect: a server that accepts and
+// then never answers would hold the caller forever.
+//
+//   POST /scores   name=<name>&score=<n>   -> rank=<r>
+//   POST /scores/batch  "<name> <n>" lines  -> one rank per line (0 = rejected)
+//   GET  /top?n=<count>                    -> "<rank> <name> <score>" lines
+//   GET  /rank?name=<name>                 -> rank=<r> score=<s>
+//   GET  /rank?score=<n>                   -> rank=<r>
+class LeaderboardClient {
+public:
+    LeaderboardClient(const std::string& host, unsigned short port) : host(host), port(port) {}
+
+    // Returns the rank, or 0 if the service could not be reached.
+    std::size_t submit(const std::string& name, std::int64_t score, sf::Time timeout = sf::seconds(2)) {
+        std::string body;
+        if (!exchange("POST", "/scores", "name=" + name + "&score=" + std::to_string(score), body, timeout)) return 0;
+        return body.compare(0, 5, "rank=") == 0 ? std::strtoul(body.c_str() + 5, nullptr, 10) : 0;
+    }
+
+    // One request for many scores. ranks gets one entry per submission.
+    bool submitBatch(const std::vector<ScoreEntry>& entries, std::vector<std::size_t>& ranks, sf::Time timeout = sf::seconds(2)) {
+        std::string body;
+        for (const ScoreEntry& e : entries) body += e.name + " " + std::to_string(e.score) + "\n";
+        std::string answer;
+        if (!exchange("POST", "/scores/batch", body, answer, timeout)) return false;
+        ranks.clear();
+        std::istringstream in(answer);
+        std::size_t rank;
+        while (in >> rank) ranks.push_back(rank);
+        return ranks.size() == entries.size();
+    }
+
+    bool fetchTop(std::size_t count, std::vector<ScoreEntry>& out, sf::Time timeout = sf::seconds(2)) {
+        std::string answer;
+        if (!exchange("GET", "/top?n=" + std::to_string(count), std::string(), answer, timeout)) return false;
+        out.clear();
+        std::istringstream in(answer);
+        std::size_t rank;
+        ScoreEntry entry;
+        while (in >> rank >> entry.name >> entry.score) out.push_back(entry);
+        return true;
+    }
+
+    // Any thread: makes the request in progress, and every later one, fail
+    // within a poll slice.
+    void cancel() { cancelled.store(true); }
+
+private:
+    static constexpr int pollMilliseconds = 50;
+
+    // Sends the request and reads the answer without ever blocking for more
+    // than a poll slice. True with the body of a 200 response.
+    bool exchange(const std::string& method, const std::string& path, const std::string& body, std::string& answer, sf::Time timeout) {
+        if (cancelled.load()) return false;
+        if (address == sf::IpAddress::None) address = sf::IpAddress(host);
+        if (address == sf::IpAddress::None) return false;
+
+        sf::Clock clock;
+        sf::TcpSocket socket;
+        if (socket.connect(address, port, timeout) != sf::Socket::Done) return false;
+        socket.setBlocking(false);
+        sf::SocketSelector selector;
+        selector.add(socket);
+
+        const std::string request = method + " " + path + " HTTP/1.0\r\nHost: " + host +
+                                    "\r\nContent-Type: application/x-www-form-urlencoded\r\nContent-Length: " +
+                                    std::to_string(body.size()) + "\r\n\r\n" + body;
+        std::size_t sentTotal = 0;
+        std::string response;
+        char buffer[4096];
+        for (;;) {
+            const sf::Time left = timeout - clock.getElapsedTime();
+            if (cancelled.load() || left <= sf::Time::Zero) return false;
+            const sf::Time slice = std::min(left, sf::milliseconds(pollMilliseconds));
+            if (sentTotal < request.size()) {
+                std::size_t sent = 0;
+                sf::Socket::Status status = socket.send(request.data() + sentTotal, request.size() - sentTotal, sent);
+                if (status == sf::Socket::Done) sent = request.size() - sentTotal;
+                else if (status != sf::Socket::Partial && status != sf::Socket::NotReady) return false;
+                sentTotal += sent;
+                if (sentTotal < request.size()) sf::sleep(slice);
+                continue;
+            }
+            selector.wait(slice);
+            std::size_t received = 0;
+            sf::Socket::Status status = socket.receive(buffer, sizeof(buffer), received);
+            if (status == sf::Socket::Done) response.append(buffer, received);
+            else if (status == sf::Socket::Disconnected) break;
+            else if (status != sf::Socket::NotReady) return false;
+            // Done as soon as Content-Length bytes are in, closed or not.
+            std::size_t headerEnd = response.find("\r\n\r\n");
+            std::size_t lengthAt = response.find("Content-Length: ");
+            if (headerEnd != std::string::npos && lengthAt < headerEnd &&
+                response.size() >= headerEnd + 4 + std::strtoul(response.c_str() + lengthAt + 16, nullptr, 10))
+                break;
+        }
+        std::size_t headerEnd = response.find("\r\n\r\n");
+        if (headerEnd == std::string::npos || response.compare(0, 5, "HTTP/") != 0) return false;
+        std::size_t code = response.find(' ');
+        if (code > headerEnd || std::strtoul(response.c_str() + code + 1, nullptr, 10) != 200) return false;
+        answer = response.substr(headerEnd + 4);
+        std::size_t lengthAt = response.find("Content-Length: ");
+        if (lengthAt < headerEnd) answer.resize(std::min(answer.size(), static_cast<std::size_t>(std::strtoul(response.c_str() + lengthAt + 16, nullptr, 10))));
+        return true;
+    }
+
+    std::string host;
+    unsigned short port;
+    sf::IpAddress address = sf::IpAddress::None;  // resolved on first use
+    std::atomic<bool> cancelled{false};
+};
+
+// --- Background uploads ---
+// A request from the game loop would freeze the frame for a round trip, or
+// for the whole timeout while the service is down. The game only enqueues;
+// a worker thread sends whatever has piled up as one batch, backs off
+// (1 s doubling up to a minute) while the service can't be reached, and
+// keeps unsent scores in a spool file so they survive a restart. Resending
+// a score is harmless since the service keeps each name's best, so the
+// spool is only trimmed after a batch is acknowledged.
+class ScoreUploader {
+public:
+    static constexpr std::size_t maxBatch = 64;
+
+    ScoreUploader(const std::string& host, unsigned short port, const std::string& spoolPath)
+        : client(host, port), spoolPath(spoolPath) {
+        std::ifstream in(spoolPath);
+        ScoreEntry entry;
+        while (in >> entry.name >> entry.score)
+            if (isValidPlayerName(entry.name)) unsent.push_back(entry);
+        worker = std::thread([this] { run(); });
+    }
+
+    // Gives up on a request still in flight; the spool keeps its scores
+    // for the next start.
+    ~ScoreUploader() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        client.cancel();
+        queueReady.notify_one();
+        worker.join();
+    }
+
+    // Main thread: these only take a lock and return.
+    void submit(const std::string& name, std::int64_t score) {
+        ScoreEntry entry;
+        entry.name = name;
+        entry.score = score;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            queue.push_back(entry);
+            awaiting = !backingOff;
+            // The last rank belongs to an older game.
+            rank.store(0, std::memory_order_relaxed);
+        }
+        queueReady.notify_one();
+    }
+
+    void requestTop(std::size_t count) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            topWanted = count;
+            awaiting = !backingOff;
+        }
+        queueReady.notify_one();
+    }
+
+    // Rank reported for the newest submitted score, 0 until it is in.
+    std::size_t latestRank() const { return rank.load(std::memory_order_relaxed); }
+
+    // True, with the list, when a newer top list arrived since the last call.
+    bool takeTop(std::vector<ScoreEntry>& out) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!topFresh) return false;
+        out = top;
+        topFresh = false;
+        return true;
+    }
+
+    // True while a request made by the game is still being worked on; false
+    // once it is answered or the worker has gone into backoff.
+    bool isAwaiting() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return awaiting;
+    }
+
+private:
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        Clock::time_point retryAt = Clock::now();
+        std::chrono::milliseconds backoff(0);
+        std::minstd_rand jitter(static_cast<unsigned>(Clock::now().time_since_epoch().count()));
+
+        for (;;) {
+            std::vector<ScoreEntry> fresh;
+            std::size_t topCount = 0;
+            bool quit;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                if (unsent.empty() && topWanted == 0)
+                    queueReady.wait(lock, [this] { return stopping || !queue.empty() || topWanted > 0; });
+                else if (Clock::now() < retryAt)
+                    queueReady.wait_until(lock, retryAt, [this] { return stopping; });
+                fresh.swap(queue);
+                topCount = topWanted;
+                quit = stopping;
+            }
+            if (!fresh.empty()) {
+                std::ofstream spool(spoolPath, std::ios::app);
+                for (const ScoreEntry& e : fresh) spool << e.name << ' ' << e.score << '\n';
+                unsent.insert(unsent.end(), fresh.begin(), fresh.end());
+            }
+            if (quit) return;
+            if (Clock::now() < retryAt) continue;
+
+            bool ok = true;
+            std::size_t batchRank = 0;
+            if (!unsent.empty()) {
+                std::size_t count = std::min(unsent.size(), maxBatch);
+                std::vector<ScoreEntry> batch(unsent.begin(), unsent.begin() + count);
+                std::vector<std::size_t> ranks;
+                ok = client.submitBatch(batch, ranks, timeout);
+                if (ok) {
+                    batchRank = ranks.back();
+                    unsent.erase(unsent.begin(), unsent.begin() + count);
+                    rewriteSpool();
+                }
+            }
+            std::vector<ScoreEntry> list;
+            if (ok && topCount > 0) ok = client.fetchTop(topCount, list, timeout);
+
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                // Only the rank of the newest score counts; one submitted
+                // while this batch was out resets it and is sent next.
+                if (batchRank > 0 && unsent.empty() && queue.empty()) rank.store(batchRank, std::memory_order_relaxed);
+                if (ok && topCount > 0) {
+                    top.swap(list);
+                    topFresh = true;
+                    if (topWanted == topCount) topWanted = 0;
+                }
+                if (!ok || (queue.empty() && unsent.empty() && topWanted == 0)) awaiting = false;
+                backingOff = !ok;
+            }
+            if (ok) {
+                backoff = std::chrono::milliseconds(0);
+            } else {
+                backoff = std::min(std::max(backoff * 2, std::chrono::milliseconds(1000)), std::chrono::milliseconds(60000));
+                // Up to 25% jitter so clients that lost the service together
+                // don't all come back in the same instant.
+                retryAt = Clock::now() + backoff + std::chrono::milliseconds(jitter() % (backoff.count() / 4 + 1));
+            }
+        }
+    }
+
+    void rewriteSpool() {
+        std::ofstream spool(spoolPath, std::ios::trunc);
+        for (const ScoreEntry& e : unsent) spool << e.name << ' ' << e.score << '\n';
+    }
+
+    const sf::Time timeout = sf::seconds(2);
+    LeaderboardClient client;  // worker thread only, but for cancel()
+    std::string spoolPath;
+    std::vector<ScoreEntry> unsent;  // worker thread only, mirrors the spool
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::vector<ScoreEntry> queue;
+    std::size_t topWanted = 0;
+    std::vector<ScoreEntry> top;
+    bool topFresh = false;
+    bool awaiting = false;
+    bool backingOff = false;
+    bool stopping = false;
+    std::atomic<std::size_t> rank{0};
+    std::thread worker;
+};
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "archive.hpp"
+#include "game.hpp"
+
+// --- Level data ---
+// Walls are kept bit-packed (row-major, least significant bit first), which
+// is also the on-disk layout of compiled levels.
+struct Level {
+    std::string name;
+    int cols = 0;
+    int rows = 0;
+    std::vector<std::uint8_t> wallBits;
+    SnakeSegment spawn = SnakeSegment(0, 0);
+    Direction dir = Right;
+    LevelRules rules;
+
+    void resize(int c, int r) {
+        cols = c;
+        rows = r;
+        wallBits.assign((static_cast<std::size_t>(c) * r + 7) / 8, 0);
+    }
+
+    bool isWall(int x, int y) const {
+        std::size_t i = static_cast<std::size_t>(y) * cols + x;
+        return (wallBits[i >> 3] >> (i & 7)) & 1;
+    }
+
+    void setWall(int x, int y, bool wall) {
+        std::size_t i = static_cast<std::size_t>(y) * cols + x;
+        if (wall) wallBits[i >> 3] |= static_cast<std::uint8_t>(1u << (i & 7));
+        else wallBits[i >> 3] &= static_cast<std::uint8_t>(~(1u << (i & 7)));
+    }
+};
+
+const int maxLevelSide = 4096;
+
+// --- Text level format ---
+// Human-editable source, compiled to the binary form by serpent_levelc:
+//
+//   # comment
+//   name Classic
+//   speed 5 5          base ticks/s, +1 every N points
+//   food 1             points per apple
+//   direction Right    Up / Down / Left / Right
+//   map
+//   ########
+//   #..S...#           '#' wall, '.' or ' ' floor, 'S' spawn
+//   ########
+//
+// Rows shorter than the widest one are padded with floor.
+inline bool parseDirection(const std::string& word, Direction& dir) {
+    if (word == "Up") dir = Up;
+    else if (word == "Down") dir = Down;
+    else if (word == "Left") dir = Left;
+    else if (word == "Right") dir = Right;
+    else return false;
+    return true;
+}
+
+inline const char* directionName(Direction dir) {
+    switch (dir) {
+        case Up: return "Up";
+        case Down: return "Down";
+        case Left: return "Left";
+        default: return "Right";
+    }
+}
+
+inline bool parseLevelText(std::istream& in, Level& level, std::string& error) {
+    level = Level();
+    std::vector<std::string> mapRows;
+    std::string line;
+    bool inMap = false;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (inMap) {
+            mapRows.push_back(line);
+            continue;
+        }
+        std::istringstream words(line);
+        std::string key;
+        if (!(words >> key) || key[0] == '#') continue;
+        bool ok = true;
+        if (key == "name") {
+            std::getline(words >> std::ws, level.name);
+        } else if (key == "speed") {
+            ok = static_cast<bool>(words >> level.rules.baseSpeed >> level.rules.speedStep) &&
+                 level.rules.baseSpeed > 0 && level.rules.speedStep > 0;
+        } else if (key == "food") {
+            ok = static_cast<bool>(words >> level.rules.foodScore) && level.rules.foodScore > 0;
+        } else if (key == "direction") {
+            std::string word;
+            ok = (words >> word) && parseDirection(word, level.dir);
+        } else if (key == "map") {
+            inMap = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            error = "line " + std::to_string(lineNo) + ": bad '" + key + "' entry";
+            return false;
+        }
+    }
+
+    while (!mapRows.empty() && mapRows.back().empty()) mapRows.pop_back();
+    std::size_t cols = 0;
+    for (const std::string& row : mapRows) cols = std::max(cols, row.size());
+    if (mapRows.empty() || cols == 0) {
+        error = "missing map";
+        return false;
+    }
+    if (cols > static_cast<std::size_t>(maxLevelSide) || mapRows.size() > static_cast<std::size_t>(maxLevelSide)) {
+        error = "map larger than " + std::to_string(maxLevelSide) + " cells per side";
+        return false;
+    }
+
+    level.resize(static_cast<int>(cols), static_cast<int>(mapRows.size()));
+    bool hasSpawn = false;
+    for (int y = 0; y < level.rows; ++y) {
+        const std::string& row = mapRows[y];
+        for (int x = 0; x < static_cast<int>(row.size()); ++x) {
+            char c = row[x];
+            if (c == '#') level.setWall(x, y, true);
+            else if (c == 'S') { level.spawn = SnakeSegment(x, y); hasSpawn = true; }
+            else if (c != '.' && c != ' ') {
+                error = "map row " + std::to_string(y + 1) + ": unknown cell '" + std::string(1, c) + "'";
+                return false;
+            }
+        }
+    }
+    if (!hasSpawn) {
+        error = "map has no spawn point 'S'";
+        return false;
+    }
+    if (level.name.empty()) level.name = "Untitled";
+    return true;
+}
+
+inline void writeLevelText(std::ostream& out, const Level& level) {
+    out << "name " << level.name << "\n";
+    out << "speed " << level.rules.baseSpeed << " " << level.rules.speedStep << "\n";
+    out << "food " << level.rules.foodScore << "\n";
+    out << "direction " << directionName(level.dir) << "\n";
+    out << "map\n";
+    for (int y = 0; y < level.rows; ++y) {
+        std::string row(level.cols, '.');
+        for (int x = 0; x < level.cols; ++x)
+            if (level.isWall(x, y)) row[x] = '#';
+        if (y == level.spawn.y) row[level.spawn.x] = 'S';
+        out << row << "\n";
+    }
+}
+
+// --- Binary level format ---
+// Little-endian LevelHeader followed by the packed wall bits. Loading is a
+// header check and one copy of (cols * rows / 8) bytes.
+const char levelMagic[4] = { 'S', 'R', 'L', 'V' };
+const std::uint32_t levelVersion = 1;
+const int levelNameLength = 32;
+
+struct LevelHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t cols;
+    std::uint32_t rows;
+    std::int32_t spawnX;
+    std::int32_t spawnY;
+    std::uint8_t direction;
+    std::uint8_t reserved[3];
+    std::int32_t baseSpeed;
+    std::int32_t speedStep;
+    std::int32_t foodScore;
+    char name[levelNameLength];  // NUL-padded
+};
+
+static_assert(sizeof(LevelHeader) == 72, "LevelHeader layout");
+
+inline bool writeLevelBinary(std::ostream& out, const Level& level) {
+    LevelHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, levelMagic, 4);
+    header.version = levelVersion;
+    header.cols = static_cast<std::uint32_t>(level.cols);
+    header.rows = static_cast<std::uint32_t>(level.rows);
+    header.spawnX = level.spawn.x;
+    header.spawnY = level.spawn.y;
+    header.direction = static_cast<std::uint8_t>(level.dir);
+    header.baseSpeed = level.rules.baseSpeed;
+    header.speedStep = level.rules.speedStep;
+    header.foodScore = level.rules.foodScore;
+    std::strncpy(header.name, level.name.c_str(), levelNameLength - 1);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(level.wallBits.data()), static_cast<std::streamsize>(level.wallBits.size()));
+    return static_cast<bool>(out);
+}
+
+inline bool parseLevelBinary(MemoryView data, Level& level, std::string& error) {
+    LevelHeader header;
+    if (data.size < sizeof(header)) {
+        error = "file too small";
+        return false;
+    }
+    std::memcpy(&header, data.data, sizeof(header));
+    if (std::memcmp(header.magic, levelMagic, 4) != 0 || header.version != levelVersion) {
+        error = "not a compiled level";
+        return false;
+    }
+    if (header.cols == 0 || header.rows == 0 || header.cols > static_cast<std::uint32_t>(maxLevelSide) ||
+        header.rows > static_cast<std::uint32_t>(maxLevelSide) || header.direction > Right ||
+        header.spawnX < 0 || header.spawnY < 0 || header.spawnX >= static_cast<std::int32_t>(header.cols) ||
+        header.spawnY >= static_cast<std::int32_t>(header.rows) ||
+        header.baseSpeed <= 0 || header.speedStep <= 0 || header.foodScore <= 0) {
+        error = "corrupt level header";
+        return false;
+    }
+    level.resize(static_cast<int>(header.cols), static_cast<int>(header.rows));
+    if (data.size < sizeof(header) + level.wallBits.size()) {
+        error = "truncated wall data";
+        return false;
+    }
+    std::memcpy(level.wallBits.data(), data.data + sizeof(header), level.wallBits.size());
+    if (level.isWall(header.spawnX, header.spawnY)) {
+        error = "spawn point is inside a wall";
+        return false;
+    }
+    header.name[levelNameLength - 1] = '\0';
+    level.name = header.name;
+    level.spawn = SnakeSegment(header.spawnX, header.spawnY);
+    level.dir = static_cast<Direction>(header.direction);
+    level.rules.baseSpeed = header.baseSpeed;
+    level.rules.speedStep = header.speedStep;
+    level.rules.foodScore = header.foodScore;
+    return true;
+}
+
+// Loads a compiled .lvl through a memory mapping, or parses a .txt source.
+inline bool loadLevelFile(const std::string& path, Level& level, std::string& error) {
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".txt") == 0) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        return parseLevelText(in, level, error);
+    }
+    MappedFile file;
+    if (!file.open(path)) {
+        error = "cannot open " + path;
+        return false;
+    }
+    return parseLevelBinary(file.contents(), level, error);
+}
+
+// Level files in a directory, sorted by name. A compiled .lvl hides the
+// .txt source with the same stem.
+inline std::vector<std::string> findLevelFiles(const std::string& dir) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> found;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        fs::path p = it->path();
+        if (p.extension() == ".lvl") {
+            found.push_back(p.string());
+        } else if (p.extension() == ".txt") {
+            fs::path compiled = p;
+            compiled.replace_extension(".lvl");
+            if (!fs::exists(compiled, ec)) found.push_back(p.string());
+        }
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+// --- Activating a level ---
+// Replaces the global wall grid, rules and spawn point used by game.hpp.
+inline void applyLevel(const Level& level) {
+    gridCols = level.cols;
+    gridRows = level.rows;
+    wallGrid.assign(gridRows, std::vector<bool>(gridCols, false));
+    for (int y = 0; y < gridRows; ++y)
+        for (int x = 0; x < gridCols; ++x)
+            if (level.isWall(x, y)) wallGrid[y][x] = true;
+    levelRules = level.rules;
+    levelSpawn = level.spawn;
+    levelDirection = level.dir;
+}
@@ -0,0 +1,42 @@
+// serpent_levelc - compiles text level sources into binary .lvl files.
+//
+//   serpent_levelc <level.txt> <level.lvl>
+//   serpent_levelc --decompile <level.lvl> <level.txt>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "level.hpp"
+
+int main(int argc, char** argv) {
+    bool decompile = argc == 4 && std::string(argv[1]) == "--decompile";
+    if (argc != 3 && !decompile) {
+        std::cerr << "usage: serpent_levelc <level.txt> <level.lvl>\n"
+                     "       serpent_levelc --decompile <level.lvl> <level.txt>\n";
+        return 1;
+    }
+    const char* inPath = argv[argc - 2];
+    const char* outPath = argv[argc - 1];
+
+    Level level;
+    std::string error;
+    if (!loadLevelFile(inPath, level, error)) {
+        std::cerr << "serpent_levelc: " << inPath << ": " << error << "\n";
+        return 1;
+    }
+
+    std::ofstream out(outPath, decompile ? std::ios::out : std::ios::binary);
+    if (!out) {
+        std::cerr << "serpent_levelc: cannot write " << outPath << "\n";
+        return 1;
+    }
+    if (decompile) writeLevelText(out, level);
+    else writeLevelBinary(out, level);
+    if (!out) {
+        std::cerr << "serpent_levelc: write failed\n";
+        return 1;
+    }
+    std::cout << level.name << ": " << level.cols << "x" << level.rows << " -> " << outPath << "\n";
+    return 0;
+}
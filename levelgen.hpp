@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "level.hpp"
+
+// --- Disjoint set (union-find) ---
+// Path halving plus union by size: near-constant time per operation.
+class DisjointSet {
+public:
+    explicit DisjointSet(std::size_t n) : parent(n), size(n, 1) {
+        for (std::size_t i = 0; i < n; ++i) parent[i] = static_cast<std::uint32_t>(i);
+    }
+
+    std::uint32_t find(std::uint32_t x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    void unite(std::uint32_t a, std::uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (size[a] < size[b]) std::swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+    }
+
+    // Links a singleton into the set rooted at root, skipping the finds.
+    void attach(std::uint32_t single, std::uint32_t root) {
+        parent[single] = root;
+        size[root] += 1;
+    }
+
+    bool isRoot(std::uint32_t x) const { return parent[x] == x; }
+    std::uint32_t componentSize(std::uint32_t x) { return size[find(x)]; }
+
+private:
+    std::vector<std::uint32_t> parent;
+    std::vector<std::uint32_t> size;
+};
+
+// --- Procedural level generator ---
+enum GeneratorStyle { OBSTACLES, MAZE };
+
+struct GeneratorSettings {
+    int cols = width / blockSize;
+    int rows = height / blockSize;
+    std::uint32_t seed = 1;
+    GeneratorStyle style = OBSTACLES;
+    // OBSTACLES: target fraction of interior cells covered by wall blocks.
+    // MAZE: fraction of maze walls kept; below 1.0 opens loops.
+    float density = 0.15f;
+};
+
+// Generation works on one byte per cell (1 = wall) and packs the result
+// into the level once at the end; bit twiddling per cell is the slow part
+// on big boards.
+struct CellGrid {
+    int cols = 0;
+    int rows = 0;
+    std::vector<std::uint8_t> wall;
+
+    CellGrid(int c, int r) : cols(c), rows(r), wall(static_cast<std::size_t>(c) * r, 0) {}
+    std::uint8_t& at(int x, int y) { return wall[static_cast<std::size_t>(y) * cols + x]; }
+};
+
+// Fills every free cell outside the largest 4-connected region with wall,
+// so food can never spawn somewhere the snake cannot reach. Returns the
+// number of free cells left.
+inline std::size_t keepLargestRegion(CellGrid& grid) {
+    const int cols = grid.cols, rows = grid.rows;
+    const std::uint32_t n = static_cast<std::uint32_t>(grid.wall.size());
+    const std::uint8_t* wall = grid.wall.data();
+
+    // Horizontal runs first: each free cell joins the run's first cell
+    // directly. Vertical links then only need a union where a run starts
+    // touching the row above; further contacts in the same pair of runs are
+    // already connected.
+    DisjointSet sets(n);
+    for (int y = 0; y < rows; ++y) {
+        std::uint32_t row = static_cast<std::uint32_t>(y) * cols;
+        for (int x = 1; x < cols; ++x) {
+            std::uint32_t i = row + x;
+            if (!wall[i] && !wall[i - 1]) sets.attach(i, sets.find(i - 1));
+        }
+    }
+    for (int y = 1; y < rows; ++y) {
+        std::uint32_t row = static_cast<std::uint32_t>(y) * cols;
+        for (int x = 0; x < cols; ++x) {
+            std::uint32_t i = row + x;
+            if (wall[i] || wall[i - cols]) continue;
+            if (x > 0 && !wall[i - 1] && !wall[i - 1 - cols]) continue;
+            sets.unite(i, i - cols);
+        }
+    }
+
+    std::uint32_t bestRoot = 0, bestSize = 0, freeCells = 0;
+    for (std::uint32_t i = 0; i < n; ++i) {
+        if (wall[i]) continue;
+        ++freeCells;
+        if (sets.isRoot(i) && sets.componentSize(i) > bestSize) {
+            bestSize = sets.componentSize(i);
+            bestRoot = i;
+        }
+    }
+    if (bestSize == freeCells) return bestSize;  // already one region
+
+    for (std::uint32_t i = 0; i < n; ++i) {
+        if (!grid.wall[i] && sets.find(i) != bestRoot) grid.wall[i] = 1;
+    }
+    return bestSize;
+}
+
+inline void placeObstacles(CellGrid& grid, std::mt19937& rng, float density) {
+    const int cols = grid.cols, rows = grid.rows;
+    std::size_t interior = static_cast<std::size_t>(cols - 2) * (rows - 2);
+    std::size_t target = static_cast<std::size_t>(interior * std::min(std::max(density, 0.f), 0.9f));
+    std::uniform_int_distribution<int> side(1, 4);
+    std::uniform_int_distribution<int> px(1, cols - 2), py(1, rows - 2);
+    std::size_t placed = 0;
+    // Random small blocks until the target coverage is reached; overlaps
+    // are simply counted again, which is fine for a density knob.
+    while (placed < target) {
+        int w = side(rng), h = side(rng);
+        int x0 = px(rng), y0 = py(rng);
+        for (int y = y0; y < std::min(y0 + h, rows - 1); ++y)
+            for (int x = x0; x < std::min(x0 + w, cols - 1); ++x) {
+                grid.at(x, y) = 1;
+                ++placed;
+            }
+    }
+}
+
+inline void carveMaze(CellGrid& grid, std::mt19937& rng, float keepWalls) {
+    const int cols = grid.cols, rows = grid.rows;
+    // Rooms sit on odd coordinates; everything else starts as wall.
+    for (int y = 1; y < rows - 1; ++y)
+        for (int x = 1; x < cols - 1; ++x)
+            grid.at(x, y) = !(x % 2 == 1 && y % 2 == 1);
+
+    const int roomCols = (cols - 1) / 2, roomRows = (rows - 1) / 2;
+    if (roomCols <= 0 || roomRows <= 0) return;
+    std::vector<std::uint8_t> visited(static_cast<std::size_t>(roomCols) * roomRows, 0);
+    struct Room { int x, y; };
+    std::vector<Room> stack;
+    stack.reserve(visited.size());
+    stack.push_back(Room{ 0, 0 });
+    visited[0] = 1;
+    const int dx[4] = { 1, -1, 0, 0 };
+    const int dy[4] = { 0, 0, 1, -1 };
+    while (!stack.empty()) {
+        Room room = stack.back();
+        int options[4], count = 0;
+        for (int d = 0; d < 4; ++d) {
+            int nx = room.x + dx[d], ny = room.y + dy[d];
+            if (nx >= 0 && ny >= 0 && nx < roomCols && ny < roomRows && !visited[ny * roomCols + nx])
+                options[count++] = d;
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        int d = count == 1 ? options[0] : options[rng() % count];
+        Room next{ room.x + dx[d], room.y + dy[d] };
+        grid.at(2 * room.x + 1 + dx[d], 2 * room.y + 1 + dy[d]) = 0;
+        visited[next.y * roomCols + next.x] = 1;
+        stack.push_back(next);
+    }
+
+    // Knock out a share of the remaining internal walls to add loops.
+    if (keepWalls >= 1.f) return;
+    const std::uint32_t threshold = static_cast<std::uint32_t>(std::max(keepWalls, 0.f) * 4294967295.0);
+    for (int y = 1; y < rows - 1; ++y)
+        for (int x = 1 + (y % 2 == 1); x < cols - 1; x += 2)
+            grid.at(x, y) &= static_cast<std::uint8_t>(rng() <= threshold);
+}
+
+// Picks a free spawn cell with two free cells ahead in some direction.
+inline bool chooseSpawn(CellGrid& grid, std::mt19937& rng, SnakeSegment& spawn, Direction& dir) {
+    const std::size_t n = grid.wall.size();
+    const Direction dirs[4] = { Right, Down, Left, Up };
+    const int dx[4] = { 1, 0, -1, 0 };
+    const int dy[4] = { 0, 1, 0, -1 };
+    std::size_t start = rng() % n;
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t i = (start + k) % n;
+        int x = static_cast<int>(i % grid.cols), y = static_cast<int>(i / grid.cols);
+        if (grid.wall[i]) continue;
+        for (int d = 0; d < 4; ++d) {
+            int x2 = x + 2 * dx[d], y2 = y + 2 * dy[d];
+            if (x2 < 0 || y2 < 0 || x2 >= grid.cols || y2 >= grid.rows) continue;
+            if (!grid.at(x + dx[d], y + dy[d]) && !grid.at(x2, y2)) {
+                spawn = SnakeSegment(x, y);
+                dir = dirs[d];
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Same seed and settings always give the same level. Every free cell of
+// the result is reachable from every other one.
+inline Level generateLevel(const GeneratorSettings& settings) {
+    CellGrid grid(std::max(settings.cols, 5), std::max(settings.rows, 5));
+    for (int x = 0; x < grid.cols; ++x) grid.at(x, 0) = grid.at(x, grid.rows - 1) = 1;
+    for (int y = 0; y < grid.rows; ++y) grid.at(0, y) = grid.at(grid.cols - 1, y) = 1;
+
+    std::mt19937 rng(settings.seed);
+    if (settings.style == MAZE) carveMaze(grid, rng, settings.density);
+    else placeObstacles(grid, rng, settings.density);
+    keepLargestRegion(grid);
+
+    Level level;
+    level.name = settings.style == MAZE ? "Maze" : "Obstacles";
+    if (!chooseSpawn(grid, rng, level.spawn, level.dir)) {
+        // Degenerate settings: fall back to an open interior.
+        for (int y = 1; y < grid.rows - 1; ++y)
+            for (int x = 1; x < grid.cols - 1; ++x)
+                grid.at(x, y) = 0;
+        chooseSpawn(grid, rng, level.spawn, level.dir);
+    }
+
+    level.resize(grid.cols, grid.rows);
+    for (std::size_t i = 0; i < grid.wall.size(); ++i)
+        level.wallBits[i >> 3] |= static_cast<std::uint8_t>(grid.wall[i] << (i & 7));
+    return level;
+}
+
+// --- Endless mode ---
+// A fresh board every endlessStagePoints points: obstacles first, mazes
+// from stage 3, getting denser as the stages go up.
+const int endlessStagePoints = 10;
+
+inline GeneratorSettings endlessStageSettings(std::uint32_t runSeed, int stage) {
+    GeneratorSettings settings;
+    settings.seed = runSeed * 7919u + static_cast<std::uint32_t>(stage);
+    if (stage >= 3 && stage % 2 == 1) {
+        settings.style = MAZE;
+        settings.density = std::max(0.2f, 0.6f - 0.05f * stage);
+    } else {
+        settings.density = std::min(0.06f + 0.03f * stage, 0.3f);
+    }
+    return settings;
+}
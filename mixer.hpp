@@ -0,0 +1,254 @@
+#pragma once
+
+#include <SFML/Audio.hpp>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SERPENT_MIXER_SSE2 1
+#endif
+
+// --- Sample mixing kernels ---
+// acc[i] += samples[i] * gain, with gain in Q15 fixed point (32768 = 1.0).
+// The SIMD multiply takes 16-bit gains, so unity is mixed as 32767 on
+// every path and the scalar tail matches the vector body.
+inline void mixAccumulate(int* acc, const sf::Int16* samples, std::size_t count, int gain) {
+    gain = std::max(0, std::min(gain, 32767));
+    std::size_t i = 0;
+#ifdef SERPENT_MIXER_SSE2
+    const __m128i g = _mm_set1_epi16(static_cast<short>(gain));
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        __m128i lo = _mm_mullo_epi16(s, g);
+        __m128i hi = _mm_mulhi_epi16(s, g);
+        __m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15);
+        __m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15);
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), p0));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), p1));
+    }
+#endif
+    for (; i < count; ++i)
+        acc[i] += (samples[i] * gain) >> 15;
+}
+
+// out[i] = saturate16(acc[i])
+inline void mixResolve(sf::Int16* out, const int* acc, std::size_t count) {
+    std::size_t i = 0;
+#ifdef SERPENT_MIXER_SSE2
+    for (; i + 8 <= count; i += 8) {
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a0, a1));
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = static_cast<sf::Int16>(std::max(-32768, std::min(32767, acc[i])));
+}
+
+enum SoundPriority { PRIORITY_LOW, PRIORITY_NORMAL, PRIORITY_HIGH };
+
+// --- Audio mixer ---
+// One sf::SoundStream that plays the background music and every sound
+// effect, so the game holds a single OpenAL source. Effects are converted
+// to the stream format once when added and mixed from a fixed pool of voice
+// slots, so playEffect() never allocates and overlapping effects don't cut
+// each other off.
+class AudioMixer : public sf::SoundStream {
+public:
+    static constexpr unsigned int channels = 2;
+    static constexpr std::size_t chunkFrames = 512;  // ~12 ms at 44.1 kHz
+    static constexpr int maxVoices = 8;
+    static constexpr int maxVoicesPerClip = 4;
+
+    AudioMixer() {
+        initialize(channels, 44100);
+    }
+
+    ~AudioMixer() {
+        stop();
+    }
+
+    // Opens the music from memory (the data must outlive the mixer) and
+    // adopts its sample rate. Call before adding effects.
+    bool openMusic(const void* data, std::size_t size) {
+        stop();
+        if (!music.openFromMemory(data, size)) return false;
+        musicChannels = music.getChannelCount();
+        if (musicChannels < 1 || musicChannels > 2) return false;
+        initialize(channels, music.getSampleRate());
+        hasMusic = true;
+        return true;
+    }
+
+    void setMusicPaused(bool paused) {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        musicPaused = paused;
+    }
+
+    // Converts the buffer to the mixer's rate and channel layout. Returns a
+    // clip id for playEffect(), or -1 for an empty buffer.
+    int addEffect(const sf::SoundBuffer& buffer) {
+        std::vector<sf::Int16> clip = convertClip(buffer);
+        if (clip.empty()) return -1;
+        std::lock_guard<std::mutex> lock(commandMutex);
+        clips.push_back(std::move(clip));
+        return static_cast<int>(clips.size()) - 1;
+    }
+
+    // Swaps the samples behind an existing clip id (hot reload). Voices
+    // still playing the old samples are cut.
+    bool replaceEffect(int clipId, const sf::SoundBuffer& buffer) {
+        std::vector<sf::Int16> clip = convertClip(buffer);
+        if (clip.empty()) return false;
+        std::lock_guard<std::mutex> lock(commandMutex);
+        if (clipId < 0 || clipId >= static_cast<int>(clips.size())) return false;
+        for (Voice& v : voices)
+            if (v.clip == clipId) v.clip = -1;
+        clips[clipId].swap(clip);
+        return true;
+    }
+
+    // Starts an effect in the voice pool. A clip never holds more than
+    // maxVoicesPerClip voices (its oldest one is restarted instead). When
+    // every voice is busy the lowest-priority, then oldest, voice is stolen,
+    // unless all playing voices outrank the new effect. volume is clamped
+    // to [0, 1].
+    void playEffect(int clip, int priority = PRIORITY_NORMAL, float volume = 1.f) {
+        if (clip < 0) return;
+        std::lock_guard<std::mutex> lock(commandMutex);
+        Voice* target = nullptr;
+        Voice* oldestSameClip = nullptr;
+        int sameClip = 0;
+        for (Voice& v : voices) {
+            if (v.clip == clip) {
+                ++sameClip;
+                if (!oldestSameClip || v.startedAt < oldestSameClip->startedAt) oldestSameClip = &v;
+            }
+            if (!target && v.clip < 0) target = &v;
+        }
+        if (sameClip >= maxVoicesPerClip) {
+            target = oldestSameClip;
+        } else if (!target) {
+            for (Voice& v : voices) {
+                if (!target || v.priority < target->priority ||
+                    (v.priority == target->priority && v.startedAt < target->startedAt))
+                    target = &v;
+            }
+            if (target->priority > priority) return;
+        }
+        target->clip = clip;
+        target->position = 0;
+        target->gain = static_cast<int>(std::max(0.f, std::min(volume, 1.f)) * 32768);
+        target->priority = priority;
+        target->startedAt = ++playCounter;
+    }
+
+protected:
+    bool onGetData(Chunk& data) override {
+        const std::size_t samples = chunkFrames * channels;
+        std::fill(accumulator, accumulator + samples, 0);
+
+        // Music is decoded outside the lock; only this thread touches it.
+        bool paused;
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            paused = musicPaused;
+        }
+        if (hasMusic && !paused) {
+            std::size_t wanted = chunkFrames * musicChannels;
+            std::size_t got = 0;
+            bool rewound = false;
+            while (got < wanted) {
+                std::size_t n = static_cast<std::size_t>(music.read(musicBuffer + got, wanted - got));
+                if (n == 0) {
+                    if (rewound) break;  // empty stream
+                    music.seek(0);       // loop
+                    rewound = true;
+                    continue;
+                }
+                got += n;
+                rewound = false;
+            }
+            std::fill(musicBuffer + got, musicBuffer + wanted, 0);
+            if (musicChannels == 1) {
+                for (std::size_t i = chunkFrames; i-- > 0;) {
+                    musicBuffer[2 * i] = musicBuffer[i];
+                    musicBuffer[2 * i + 1] = musicBuffer[i];
+                }
+            }
+            mixAccumulate(accumulator, musicBuffer, samples, musicGain);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(commandMutex);
+            for (Voice& v : voices) {
+                if (v.clip < 0) continue;
+                const std::vector<sf::Int16>& clip = clips[v.clip];
+                std::size_t n = std::min(samples, clip.size() - v.position);
+                mixAccumulate(accumulator, clip.data() + v.position, n, v.gain);
+                v.position += n;
+                if (v.position >= clip.size()) v.clip = -1;
+            }
+        }
+
+        mixResolve(output, accumulator, samples);
+        data.samples = output;
+        data.sampleCount = samples;
+        return true;
+    }
+
+    void onSeek(sf::Time timeOffset) override {
+        if (hasMusic) music.seek(timeOffset);
+    }
+
+private:
+    std::vector<sf::Int16> convertClip(const sf::SoundBuffer& buffer) const {
+        std::size_t frames = buffer.getSampleCount() / std::max(1u, buffer.getChannelCount());
+        if (frames == 0) return std::vector<sf::Int16>();
+        const sf::Int16* src = buffer.getSamples();
+        unsigned int srcChannels = buffer.getChannelCount();
+        double step = static_cast<double>(buffer.getSampleRate()) / getSampleRate();
+        std::size_t outFrames = static_cast<std::size_t>(frames / step);
+
+        std::vector<sf::Int16> clip(outFrames * channels);
+        for (std::size_t f = 0; f < outFrames; ++f) {
+            double pos = f * step;
+            std::size_t i0 = static_cast<std::size_t>(pos);
+            std::size_t i1 = std::min(i0 + 1, frames - 1);
+            double t = pos - i0;
+            for (unsigned int c = 0; c < channels; ++c) {
+                unsigned int sc = std::min(c, srcChannels - 1);
+                double s = src[i0 * srcChannels + sc] * (1.0 - t) + src[i1 * srcChannels + sc] * t;
+                clip[f * channels + c] = static_cast<sf::Int16>(s);
+            }
+        }
+        return clip;
+    }
+
+    struct Voice {
+        int clip = -1;
+        std::size_t position = 0;  // in samples
+        int gain = 32768;
+        int priority = PRIORITY_NORMAL;
+        unsigned long long startedAt = 0;
+    };
+
+    sf::InputSoundFile music;
+    unsigned int musicChannels = 2;
+    bool hasMusic = false;
+    bool musicPaused = false;
+    int musicGain = 32768 * 7 / 10;  // leave headroom for effects
+
+    std::mutex commandMutex;
+    std::vector<std::vector<sf::Int16>> clips;
+    Voice voices[maxVoices];
+    unsigned long long playCounter = 0;
+
+    int accumulator[chunkFrames * channels];
+    sf::Int16 musicBuffer[chunkFrames * channels];
+    sf::Int16 output[chunkFrames * channels];
+};
@@ -0,0 +1,708 @@
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "arena.hpp"
+#include "snapshot.hpp"
+
+// --- Wire protocol ---
+// Everything travels over UDP as sf::Packet, first field the message type.
+//
+//   client -> server   JOIN       version:u16
+//                      INPUT      seq:u32 count:u8 direction:u8 * count
+//                      KEYFRAME?  (missed a delta)
+//                      LEAVE
+//   server -> client   WELCOME    playerId:u16 cols:u16 rows:u16 tickRate:u8
+//                      KEYFRAME   tick:u32 ackSeq:u32 bits   (snapshot.hpp)
+//                      DELTA      tick:u32 ackSeq:u32 bits
+//                      KEYFRAME_PART  tick:u32 ackSeq:u32 part:u8 parts:u8 bytes
+//
+// A keyframe too big for one datagram goes out as KEYFRAME_PARTs of at
+// most keyframePartBytes each; the client decodes it once every part of
+// that tick has arrived. Losing one part loses the keyframe, as losing an
+// IP fragment of one big datagram would, and the client asks again.
+//
+// Spectators get the server -> client half over TCP instead: a WELCOME with
+// playerId 0xFFFF, a KEYFRAME, then one DELTA per tick, never asking for
+// anything since TCP loses nothing.
+//
+// The client sends one input per tick, numbered consecutively; each packet
+// repeats the last few so a lost one is covered by the next. The server
+// queues them and applies one per tick, in order, and every snapshot echoes
+// the number of the last input applied. Client-side prediction
+// (prediction.hpp) relies on that one-to-one mapping.
+const unsigned short defaultServerPort = 53000;
+const sf::Uint16 protocolVersion = 5;
+const int inputRedundancy = 4;  // inputs per INPUT packet
+const sf::Uint16 spectatorId = 0xFFFF;
+const std::size_t keyframePartBytes = 60000;  // leaves room for headers in a 65507-byte datagram
+const std::size_t maxKeyframeParts = 255;
+
+enum MessageType { MSG_JOIN, MSG_WELCOME, MSG_INPUT, MSG_LEAVE, MSG_KEYFRAME, MSG_DELTA, MSG_KEYFRAME_REQUEST, MSG_KEYFRAME_PART };
+
+// The bit payload is the rest of the packet after the header.
+inline void writeSnapshotPacket(sf::Packet& packet, MessageType type, std::uint32_t tick, std::uint32_t ackSeq, const BitWriter& bits) {
+    packet << static_cast<sf::Uint8>(type) << static_cast<sf::Uint32>(tick) << static_cast<sf::Uint32>(ackSeq);
+    packet.append(bits.data(), bits.size());
+}
+
+// Collects the parts of one split keyframe. A part of a newer tick throws
+// away what was collected so far; the parts of a tick may arrive in any
+// order.
+class KeyframeAssembler {
+public:
+    // True once every part of tick is in; bytes() then holds the keyframe.
+    bool add(std::uint32_t tick, std::size_t part, std::size_t parts, const char* data, std::size_t size) {
+        if (parts == 0 || part >= parts) return false;
+        if (tick != partTick || parts != received.size()) {
+            partTick = tick;
+            received.assign(parts, false);
+            pieces.assign(parts, std::vector<char>());
+            missing = parts;
+        }
+        if (received[part]) return false;
+        received[part] = true;
+        pieces[part].assign(data, data + size);
+        if (--missing > 0) return false;
+        assembled.clear();
+        for (const std::vector<char>& piece : pieces) assembled.insert(assembled.end(), piece.begin(), piece.end());
+        received.clear();
+        return true;
+    }
+
+    const std::vector<char>& bytes() const { return assembled; }
+
+private:
+    std::uint32_t partTick = 0;
+    std::size_t missing = 0;
+    std::vector<bool> received;
+    std::vector<std::vector<char>> pieces;
+    std::vector<char> assembled;
+};
+
+// --- Spectator fan-out ---
+// Read-only viewers are served from a thread of their own, so the tick
+// only pays for framing each message once: exactly as sf::TcpSocket frames
+// an sf::Packet (32-bit big-endian size, then the bytes), into an immutable
+// shared buffer. The sender thread queues that one buffer for every viewer
+// and sends with non-blocking writes. A viewer that falls more than
+// maxBacklog bytes behind, or has gone away, is dropped; neither the tick
+// nor the other viewers ever wait for it.
+//
+// The selector only watches the listener. sf::SocketSelector is built on
+// select(), which can't take descriptors past FD_SETSIZE (1024 on Linux),
+// and it only reports readability anyway; viewers send nothing, and a
+// closed one shows up as a failed send.
+using SharedFrame = std::shared_ptr<const std::vector<char>>;
+
+inline SharedFrame frameMessage(const sf::Packet& packet) {
+    const std::size_t size = packet.getDataSize();
+    std::shared_ptr<std::vector<char>> frame = std::make_shared<std::vector<char>>(4 + size);
+    for (int i = 0; i < 4; ++i) (*frame)[i] = static_cast<char>((size >> (24 - 8 * i)) & 0xFF);
+    if (size) std::memcpy(frame->data() + 4, packet.getData(), size);
+    return frame;
+}
+
+class SpectatorHub {
+public:
+    static constexpr std::size_t maxBacklog = 256 * 1024;  // bytes queued per viewer
+    static constexpr std::size_t maxPublished = 40;        // ticks the sender may lag
+
+    struct Stats {
+        std::uint64_t accepted = 0;
+        std::uint64_t dropped = 0;  // too slow, or disconnected
+        std::size_t peakViewers = 0;
+        std::uint64_t bytesSent = 0;
+    };
+
+    ~SpectatorHub() { stop(); }
+
+    bool listen(unsigned short port, const sf::IpAddress& address, int cols, int rows, int tickRate) {
+        if (listener.listen(port, address) != sf::Socket::Done) return false;
+        listener.setBlocking(false);
+        selector.add(listener);
+        sf::Packet welcome;
+        welcome << static_cast<sf::Uint8>(MSG_WELCOME) << spectatorId << static_cast<sf::Uint16>(cols)
+                << static_cast<sf::Uint16>(rows) << static_cast<sf::Uint8>(tickRate);
+        welcomeFrame = frameMessage(welcome);
+        worker = std::thread([this] { run(); });
+        return true;
+    }
+
+    // Stops the sender thread; the statistics are final afterwards.
+    void stop() {
+        if (!worker.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // Tick thread: true while a viewer waits for its first keyframe.
+    bool wantsKeyframe() const { return keyframeWanted.load(); }
+
+    // Tick thread, once per tick after the encoder ran; keyframe is null
+    // when it built none. If the sender has fallen maxPublished ticks
+    // behind, the backlog is thrown away and every viewer starts over
+    // from the next keyframe.
+    void publish(std::uint32_t tick, const BitWriter& delta, const BitWriter* keyframe) {
+        if (!worker.joinable() || viewerCount.load() == 0) return;
+        Published item;
+        sf::Packet packet;
+        writeSnapshotPacket(packet, MSG_DELTA, tick, 0, delta);
+        item.delta = frameMessage(packet);
+        if (keyframe) {
+            sf::Packet key;
+            writeSnapshotPacket(key, MSG_KEYFRAME, tick, 0, *keyframe);
+            item.keyframe = frameMessage(key);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (published.size() >= maxPublished) {
+                published.clear();
+                resync = true;
+            }
+            published.push_back(std::move(item));
+        }
+        wake.notify_one();
+    }
+
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Published {
+        SharedFrame delta;
+        SharedFrame keyframe;  // null if none was built this tick
+    };
+
+    struct Viewer {
+        std::unique_ptr<sf::TcpSocket> socket;
+        std::deque<SharedFrame> queue;
+        std::size_t offset = 0;   // bytes of queue.front() already sent
+        std::size_t backlog = 0;  // bytes queued and not yet sent
+        bool started = false;     // has been sent a keyframe
+    };
+
+    void run() {
+        std::deque<Published> batch;
+        for (;;) {
+            bool restart = false;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // Wakes up on its own now and then to accept connections.
+                wake.wait_for(lock, std::chrono::milliseconds(20), [this] { return stopping || !published.empty(); });
+                if (stopping) break;
+                batch.swap(published);
+                restart = resync;
+                resync = false;
+            }
+            acceptViewers();
+            if (restart)
+                for (Viewer& v : viewers) v.started = false;
+            for (const Published& item : batch) {
+                for (Viewer& v : viewers) {
+                    if (v.started) {
+                        enqueue(v, item.delta);
+                    } else if (item.keyframe) {
+                        enqueue(v, item.keyframe);
+                        v.started = true;
+                    }
+                }
+            }
+            batch.clear();
+            sendAll();
+        }
+    }
+
+    void acceptViewers() {
+        // A zero timeout would mean "forever" to SFML.
+        while (selector.wait(sf::microseconds(1)) && selector.isReady(listener)) {
+            std::unique_ptr<sf::TcpSocket> socket(new sf::TcpSocket);
+            if (listener.accept(*socket) != sf::Socket::Done) break;
+            socket->setBlocking(false);
+            Viewer viewer;
+            viewer.socket = std::move(socket);
+            enqueue(viewer, welcomeFrame);
+            viewers.push_back(std::move(viewer));
+            stats.accepted++;
+            stats.peakViewers = std::max(stats.peakViewers, viewers.size());
+        }
+        bool waiting = false;
+        for (const Viewer& v : viewers) waiting = waiting || !v.started;
+        keyframeWanted.store(waiting);
+        viewerCount.store(viewers.size());
+    }
+
+    void sendAll() {
+        size_t kept = 0;
+        for (size_t i = 0; i < viewers.size(); ++i) {
+            if (flush(viewers[i])) {
+                if (kept != i) viewers[kept] = std::move(viewers[i]);
+                ++kept;
+            } else {
+                stats.dropped++;
+            }
+        }
+        viewers.resize(kept);
+        viewerCount.store(viewers.size());
+    }
+
+    static void enqueue(Viewer& v, const SharedFrame& frame) {
+        v.queue.push_back(frame);
+        v.backlog += frame->size();
+    }
+
+    // Sends as much as the socket takes right now. False drops the viewer.
+    bool flush(Viewer& v) {
+        while (!v.queue.empty()) {
+            const std::vector<char>& frame = *v.queue.front();
+            std::size_t sent = 0;
+            sf::Socket::Status status = v.socket->send(frame.data() + v.offset, frame.size() - v.offset, sent);
+            v.offset += sent;
+            v.backlog -= sent;
+            stats.bytesSent += sent;
+            if (status == sf::Socket::Done) {
+                v.queue.pop_front();
+                v.offset = 0;
+            } else if (status == sf::Socket::Partial || status == sf::Socket::NotReady) {
+                return v.backlog <= maxBacklog;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Sender thread only.
+    sf::TcpListener listener;
+    sf::SocketSelector selector;
+    SharedFrame welcomeFrame;
+    std::vector<Viewer> viewers;
+    Stats stats;
+
+    // Shared with the tick thread.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Published> published;
+    bool resync = false;
+    bool stopping = false;
+    std::atomic<bool> keyframeWanted{false};
+    std::atomic<std::size_t> viewerCount{0};
+    std::thread worker;
+};
+
+// --- Authoritative arena server ---
+// Owns one Arena and one UDP socket and runs the whole loop on the calling
+// thread: drain inputs, tick, send every client a snapshot, sleep until the
+// next tick. A process hosts several arenas by giving each its own thread
+// and port.
+class ArenaServer {
+public:
+    struct Stats {
+        std::uint64_t ticks = 0;
+        double tickSecondsTotal = 0;  // simulate + send, excluding sleep
+        double tickSecondsMax = 0;
+        std::uint64_t bytesSent = 0;
+        std::uint64_t bytesReceived = 0;
+        std::size_t peakClients = 0;
+        std::uint64_t oversized = 0;  // packets too big for one datagram
+        std::uint64_t splitKeyframes = 0;
+    };
+
+    ArenaServer(int cols, int rows, int maxPlayers, int tickRate, std::uint32_t seed)
+        : arena(cols, rows, seed), maxPlayers(maxPlayers), tickRate(tickRate) {}
+
+    bool bind(unsigned short port, const sf::IpAddress& address = sf::IpAddress::Any) {
+        if (socket.bind(port, address) != sf::Socket::Done) return false;
+        socket.setBlocking(false);
+        return true;
+    }
+
+    void run(const std::atomic<bool>& stop) {
+        const sf::Time step = sf::seconds(1.f / tickRate);
+        sf::Clock clock;
+        sf::Time next = clock.getElapsedTime();
+        while (!stop.load()) {
+            receiveAll();
+            sf::Time start = clock.getElapsedTime();
+            applyInputs();
+            arena.tick();
+            dropSilentClients();
+            broadcast();
+            double spent = (clock.getElapsedTime() - start).asSeconds();
+            stats.ticks++;
+            stats.tickSecondsTotal += spent;
+            stats.tickSecondsMax = std::max(stats.tickSecondsMax, spent);
+
+            next += step;
+            sf::Time now = clock.getElapsedTime();
+            if (next > now) sf::sleep(next - now);
+            else if (now - next > step * 4.f) next = now;  // overloaded: don't try to catch up
+        }
+        spectators.stop();
+    }
+
+    // Read-only viewers over TCP; see SpectatorHub. Call before run().
+    bool listenSpectators(unsigned short port, const sf::IpAddress& address = sf::IpAddress::Any) {
+        return spectators.listen(port, address, arena.getCols(), arena.getRows(), tickRate);
+    }
+
+    const Stats& getStats() const { return stats; }
+    const SpectatorHub::Stats& getSpectatorStats() const { return spectators.getStats(); }
+
+private:
+    struct Client {
+        sf::IpAddress address;
+        unsigned short port = 0;
+        int playerId = -1;
+        std::uint32_t lastSeq = 0;  // newest input received
+        std::deque<Direction> pending;  // received, not yet applied; ends at lastSeq
+        std::uint32_t lastHeardTick = 0;
+        bool needsKeyframe = true;
+    };
+
+    Client* findClient(const sf::IpAddress& address, unsigned short port) {
+        for (Client& c : clients)
+            if (c.address == address && c.port == port) return &c;
+        return nullptr;
+    }
+
+    void receiveAll() {
+        sf::Packet packet;
+        sf::IpAddress address;
+        unsigned short port;
+        while (socket.receive(packet, address, port) == sf::Socket::Done) {
+            stats.bytesReceived += packet.getDataSize();
+            sf::Uint8 type;
+            if (!(packet >> type)) continue;
+            Client* client = findClient(address, port);
+            if (type == MSG_JOIN) {
+                sf::Uint16 version;
+                if (!(packet >> version) || version != protocolVersion) continue;
+                if (!client) {
+                    if (static_cast<int>(clients.size()) >= maxPlayers) continue;
+                    Client c;
+                    c.address = address;
+                    c.port = port;
+                    c.playerId = arena.addPlayer();
+                    clients.push_back(c);
+                    client = &clients.back();
+                    stats.peakClients = std::max(stats.peakClients, clients.size());
+                }
+                client->lastHeardTick = arena.getTick();
+                // Resent on duplicate JOINs in case the first WELCOME was lost.
+                sf::Packet welcome;
+                welcome << static_cast<sf::Uint8>(MSG_WELCOME) << static_cast<sf::Uint16>(client->playerId)
+                        << static_cast<sf::Uint16>(arena.getCols()) << static_cast<sf::Uint16>(arena.getRows())
+                        << static_cast<sf::Uint8>(tickRate);
+                send(welcome, *client);
+            } else if (!client) {
+                continue;
+            } else if (type == MSG_INPUT) {
+                sf::Uint32 seq;
+                sf::Uint8 count;
+                if (!(packet >> seq >> count) || count == 0 || count > inputRedundancy || seq < count) continue;
+                client->lastHeardTick = arena.getTick();
+                for (sf::Uint32 s = seq - count + 1; s <= seq; ++s) {
+                    sf::Uint8 dir;
+                    if (!(packet >> dir) || dir > Right) break;
+                    // Inputs lost beyond the redundancy are skipped over.
+                    if (s <= client->lastSeq) continue;
+                    client->pending.push_back(static_cast<Direction>(dir));
+                    client->lastSeq = s;
+                }
+            } else if (type == MSG_KEYFRAME_REQUEST) {
+                client->needsKeyframe = true;
+            } else if (type == MSG_LEAVE) {
+                arena.removePlayer(client->playerId);
+                clients.erase(clients.begin() + (client - clients.data()));
+            }
+        }
+    }
+
+    // One input per client per tick. Without a new one the snake keeps its
+    // direction. A client whose clock runs ahead builds up a queue, which is
+    // input latency; beyond maxPending the oldest inputs are dropped.
+    void applyInputs() {
+        const size_t maxPending = 3;
+        for (Client& c : clients) {
+            while (c.pending.size() > maxPending) c.pending.pop_front();
+            if (c.pending.empty()) continue;
+            arena.setDirection(c.playerId, c.pending.front());
+            c.pending.pop_front();
+        }
+    }
+
+    void dropSilentClients() {
+        const std::uint32_t timeoutTicks = static_cast<std::uint32_t>(tickRate) * 5;
+        for (size_t i = clients.size(); i-- > 0;) {
+            if (arena.getTick() - clients[i].lastHeardTick > timeoutTicks) {
+                arena.removePlayer(clients[i].playerId);
+                clients.erase(clients.begin() + i);
+            }
+        }
+    }
+
+    // The state is encoded once per tick; clients only differ in the
+    // acknowledged input number and in whether they need a keyframe.
+    void broadcast() {
+        bool wanted = spectators.wantsKeyframe();
+        for (const Client& c : clients) wanted = wanted || c.needsKeyframe;
+        encoder.encode(wanted);
+        for (Client& c : clients) {
+            bool key = encoder.hasKeyframe() && (c.needsKeyframe || encoder.keyframeDue());
+            std::uint32_t ackSeq = c.lastSeq - static_cast<std::uint32_t>(c.pending.size());
+            if (key && encoder.keyframe().size() > keyframePartBytes) {
+                sendKeyframeParts(ackSeq, c);
+            } else {
+                sf::Packet packet;
+                writeSnapshotPacket(packet, key ? MSG_KEYFRAME : MSG_DELTA, arena.getTick(), ackSeq,
+                                    key ? encoder.keyframe() : encoder.delta());
+                send(packet, c);
+            }
+            if (key) c.needsKeyframe = false;
+        }
+        spectators.publish(arena.getTick(), encoder.delta(), encoder.hasKeyframe() ? &encoder.keyframe() : nullptr);
+    }
+
+    // Splits a keyframe too big for one datagram (about 64 players of 4k
+    // segments) into KEYFRAME_PARTs.
+    void sendKeyframeParts(std::uint32_t ackSeq, const Client& client) {
+        const BitWriter& bits = encoder.keyframe();
+        const std::size_t parts = (bits.size() + keyframePartBytes - 1) / keyframePartBytes;
+        if (parts > maxKeyframeParts) {
+            stats.oversized++;
+            return;
+        }
+        stats.splitKeyframes++;
+        for (std::size_t i = 0; i < parts; ++i) {
+            const std::size_t begin = i * keyframePartBytes;
+            sf::Packet packet;
+            packet << static_cast<sf::Uint8>(MSG_KEYFRAME_PART) << static_cast<sf::Uint32>(arena.getTick())
+                   << static_cast<sf::Uint32>(ackSeq) << static_cast<sf::Uint8>(i) << static_cast<sf::Uint8>(parts);
+            packet.append(bits.data() + begin, std::min(keyframePartBytes, bits.size() - begin));
+            send(packet, client);
+        }
+    }
+
+    // Anything else that outgrows a datagram is counted and dropped.
+    void send(sf::Packet& packet, const Client& client) {
+        std::size_t size = packet.getDataSize();
+        if (size > sf::UdpSocket::MaxDatagramSize) {
+            stats.oversized++;
+            return;
+        }
+        if (socket.send(packet, client.address, client.port) == sf::Socket::Done) stats.bytesSent += size;
+    }
+
+    Arena arena;
+    SnapshotEncoder encoder{arena};
+    int maxPlayers;
+    int tickRate;
+    sf::UdpSocket socket;
+    std::vector<Client> clients;
+    SpectatorHub spectators;
+    Stats stats;
+};
+
+// --- Client connection ---
+// Non-blocking after connect(); poll() once per frame.
+class NetClient {
+public:
+    // Sends JOIN until a WELCOME arrives or the timeout runs out.
+    bool connect(const sf::IpAddress& server, unsigned short port, sf::Time timeout = sf::seconds(2)) {
+        serverAddress = server;
+        serverPort = port;
+        if (socket.bind(sf::Socket::AnyPort) != sf::Socket::Done) return false;
+        socket.setBlocking(false);
+        sf::Clock clock;
+        sf::Time nextJoin = sf::Time::Zero;
+        while (clock.getElapsedTime() < timeout) {
+            if (clock.getElapsedTime() >= nextJoin) {
+                sf::Packet join;
+                join << static_cast<sf::Uint8>(MSG_JOIN) << protocolVersion;
+                socket.send(join, serverAddress, serverPort);
+                nextJoin += sf::milliseconds(200);
+            }
+            sf::Packet packet;
+            sf::IpAddress from;
+            unsigned short fromPort;
+            sf::Uint8 type;
+            if (socket.receive(packet, from, fromPort) == sf::Socket::Done && packet >> type && type == MSG_WELCOME) {
+                sf::Uint16 id, cols, rows;
+                sf::Uint8 rate;
+                if (packet >> id >> cols >> rows >> rate) {
+                    playerId = id;
+                    boardCols = cols;
+                    boardRows = rows;
+                    tickRate = rate;
+                    return true;
+                }
+            }
+            sf::sleep(sf::milliseconds(5));
+        }
+        return false;
+    }
+
+    // Call exactly once per tick, also without a change: the server steps
+    // one input per tick, and the stream doubles as keep-alive. Returns the
+    // input's sequence number.
+    std::uint32_t sendInput(Direction dir) {
+        ++inputSeq;
+        recentInputs[inputSeq % inputRedundancy] = dir;
+        std::uint32_t count = std::min<std::uint32_t>(inputSeq, inputRedundancy);
+        sf::Packet packet;
+        packet << static_cast<sf::Uint8>(MSG_INPUT) << static_cast<sf::Uint32>(inputSeq) << static_cast<sf::Uint8>(count);
+        for (std::uint32_t s = inputSeq - count + 1; s <= inputSeq; ++s)
+            packet << static_cast<sf::Uint8>(recentInputs[s % inputRedundancy]);
+        socket.send(packet, serverAddress, serverPort);
+        return inputSeq;
+    }
+
+    void requestKeyframe() {
+        if (keyframeClock.getElapsedTime() < sf::milliseconds(250)) return;
+        keyframeClock.restart();
+        sf::Packet packet;
+        packet << static_cast<sf::Uint8>(MSG_KEYFRAME_REQUEST);
+        socket.send(packet, serverAddress, serverPort);
+    }
+
+    void leave() {
+        sf::Packet packet;
+        packet << static_cast<sf::Uint8>(MSG_LEAVE);
+        socket.send(packet, serverAddress, serverPort);
+    }
+
+    // Drains the socket; returns true if snap moved to a newer tick. A gap
+    // in the deltas costs a keyframe request (at most one per 250 ms).
+    bool poll(ArenaSnapshot& snap) {
+        bool updated = false;
+        sf::Packet packet;
+        sf::IpAddress from;
+        unsigned short fromPort;
+        SnapshotDecoder decoder(boardCols, boardRows);
+        while (socket.receive(packet, from, fromPort) == sf::Socket::Done) {
+            bytesReceived += packet.getDataSize();
+            sf::Uint8 type;
+            sf::Uint32 tick, ackSeq;
+            if (!(packet >> type >> tick >> ackSeq) ||
+                (type != MSG_KEYFRAME && type != MSG_DELTA && type != MSG_KEYFRAME_PART))
+                continue;
+            // UDP can reorder; never go back in time.
+            if (snap.valid && tick <= snap.tick) continue;
+            sf::Uint8 part = 0, parts = 0;
+            if (type == MSG_KEYFRAME_PART && !(packet >> part >> parts)) continue;
+            const char* payload = static_cast<const char*>(packet.getData()) + packet.getReadPosition();
+            std::size_t payloadSize = packet.getDataSize() - packet.getReadPosition();
+            if (type == MSG_KEYFRAME_PART) {
+                if (!keyframeParts.add(tick, part, parts, payload, payloadSize)) continue;
+                payload = keyframeParts.bytes().data();
+                payloadSize = keyframeParts.bytes().size();
+            }
+            BitReader bits(payload, payloadSize);
+            bool ok = type == MSG_DELTA ? decoder.applyDelta(bits, tick, snap) : decoder.readKeyframe(bits, tick, snap);
+            if (ok) {
+                snap.ackSeq = ackSeq;
+                updated = true;
+            } else {
+                snap.valid = false;
+                requestKeyframe();
+            }
+        }
+        return updated;
+    }
+
+    int getPlayerId() const { return playerId; }
+    int getCols() const { return boardCols; }
+    int getRows() const { return boardRows; }
+    int getTickRate() const { return tickRate; }
+    std::uint64_t getBytesReceived() const { return bytesReceived; }
+
+private:
+    sf::UdpSocket socket;
+    sf::IpAddress serverAddress;
+    unsigned short serverPort = 0;
+    int playerId = -1;
+    int boardCols = 0;
+    int boardRows = 0;
+    int tickRate = 0;
+    std::uint32_t inputSeq = 0;
+    Direction recentInputs[inputRedundancy] = {};
+    std::uint64_t bytesReceived = 0;
+    sf::Clock keyframeClock;
+    KeyframeAssembler keyframeParts;
+};
+
+// --- Spectator connection ---
+// The viewer side of SpectatorHub. Non-blocking after connect(); poll()
+// once per frame.
+class SpectatorClient {
+public:
+    bool connect(const sf::IpAddress& server, unsigned short port, sf::Time timeout = sf::seconds(2)) {
+        if (socket.connect(server, port, timeout) != sf::Socket::Done) return false;
+        socket.setBlocking(false);
+        connected = true;
+        return true;
+    }
+
+    // Drains the socket; returns true if snap moved to a newer tick.
+    bool poll(ArenaSnapshot& snap) {
+        bool updated = false;
+        sf::Packet packet;
+        sf::Socket::Status status;
+        while ((status = socket.receive(packet)) == sf::Socket::Done) {
+            bytesReceived += packet.getDataSize() + 4;
+            sf::Uint8 type;
+            if (!(packet >> type)) continue;
+            if (type == MSG_WELCOME) {
+                sf::Uint16 id, cols, rows;
+                sf::Uint8 rate;
+                if (packet >> id >> cols >> rows >> rate) {
+                    boardCols = cols;
+                    boardRows = rows;
+                    tickRate = rate;
+                }
+                continue;
+            }
+            sf::Uint32 tick, ackSeq;
+            if (boardCols == 0 || !(packet >> tick >> ackSeq) || (type != MSG_KEYFRAME && type != MSG_DELTA)) continue;
+            SnapshotDecoder decoder(boardCols, boardRows);
+            BitReader bits(static_cast<const char*>(packet.getData()) + packet.getReadPosition(),
+                           packet.getDataSize() - packet.getReadPosition());
+            bool ok = type == MSG_KEYFRAME ? decoder.readKeyframe(bits, tick, snap) : decoder.applyDelta(bits, tick, snap);
+            if (ok) updated = true;
+            else snap.valid = false;  // the stream is broken; nothing to ask for
+        }
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error) connected = false;
+        return updated;
+    }
+
+    bool isConnected() const { return connected; }
+    int getCols() const { return boardCols; }
+    int getRows() const { return boardRows; }
+    int getTickRate() const { return tickRate; }
+    std::uint64_t getBytesReceived() const { return bytesReceived; }
+
+private:
+    sf::TcpSocket socket;
+    bool connected = false;
+    int boardCols = 0;
+    int boardRows = 0;
+    int tickRate = 0;
+    std::uint64_t bytesReceived = 0;
+};
@@ -0,0 +1,94 @@
+// serpent_pack - bundles game assets into one archive for archive.hpp.
+//
+//   serpent_pack <out.pak> <file>...
+//
+// Entries are stored under their file name (directories dropped) and start
+// on packAlignment boundaries.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "archive.hpp"
+
+static bool readFile(const std::string& path, std::vector<char>& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    out.resize(static_cast<size_t>(size));
+    return static_cast<bool>(file.read(out.data(), size));
+}
+
+static std::uint64_t alignUp(std::uint64_t value) {
+    return (value + packAlignment - 1) / packAlignment * packAlignment;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: serpent_pack <out.pak> <file>...\n";
+        return 1;
+    }
+
+    std::vector<std::vector<char>> contents;
+    std::vector<PackEntry> index;
+    std::set<std::string> names;
+    for (int i = 2; i < argc; ++i) {
+        std::string name = AssetArchive::baseName(argv[i]);
+        if (name.size() >= static_cast<size_t>(packNameLength)) {
+            std::cerr << "serpent_pack: name too long: " << name << "\n";
+            return 1;
+        }
+        if (!names.insert(name).second) {
+            std::cerr << "serpent_pack: duplicate entry: " << name << "\n";
+            return 1;
+        }
+        contents.emplace_back();
+        if (!readFile(argv[i], contents.back())) {
+            std::cerr << "serpent_pack: cannot read " << argv[i] << "\n";
+            return 1;
+        }
+        PackEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, name.c_str(), packNameLength - 1);
+        entry.size = contents.back().size();
+        index.push_back(entry);
+    }
+
+    std::uint64_t offset = alignUp(sizeof(PackHeader) + index.size() * sizeof(PackEntry));
+    for (PackEntry& entry : index) {
+        entry.offset = offset;
+        offset = alignUp(offset + entry.size);
+    }
+
+    PackHeader header;
+    std::memcpy(header.magic, packMagic, 4);
+    header.version = packVersion;
+    header.entryCount = static_cast<std::uint32_t>(index.size());
+    header.reserved = 0;
+
+    std::ofstream out(argv[1], std::ios::binary);
+    if (!out) {
+        std::cerr << "serpent_pack: cannot write " << argv[1] << "\n";
+        return 1;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(PackEntry));
+    std::uint64_t written = sizeof(header) + index.size() * sizeof(PackEntry);
+    const char zeros[packAlignment] = {};
+    for (size_t i = 0; i < index.size(); ++i) {
+        out.write(zeros, static_cast<std::streamsize>(index[i].offset - written));
+        out.write(contents[i].data(), static_cast<std::streamsize>(contents[i].size()));
+        written = index[i].offset + contents[i].size();
+    }
+    if (!out) {
+        std::cerr << "serpent_pack: write failed\n";
+        return 1;
+    }
+    std::cout << "Packed " << index.size() << " files into " << argv[1] << " (" << written << " bytes)\n";
+    return 0;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <memory>
+
+#include "atlas.hpp"
+#include "dirtyboard.hpp"
+#include "game.hpp"
+#include "gridshader.hpp"
+#include "hudtext.hpp"
+#include "particles.hpp"
+#include "smoothsnake.hpp"
+
+// --- Board view ---
+// Fits the whole board into the window, letterboxed, so levels of any size
+// are drawn in board coordinates (cell * blockSize).
+inline sf::View boardViewFor(int cols, int rows) {
+    float boardW = static_cast<float>(cols * blockSize);
+    float boardH = static_cast<float>(rows * blockSize);
+    float scale = std::min(width / boardW, height / boardH);
+    float vw = boardW * scale / width, vh = boardH * scale / height;
+    sf::View view(sf::FloatRect(0, 0, boardW, boardH));
+    view.setViewport(sf::FloatRect((1 - vw) / 2, (1 - vh) / 2, vw, vh));
+    return view;
+}
+
+// --- Playfield ---
+// The board and the score bar as drawn during a game. The window and the
+// replay exporter both draw through this, so exported frames match the
+// game exactly.
+class Playfield {
+public:
+    static constexpr size_t maxParticles = 100000;
+
+    Playfield(const TextureAtlas& atlas, const sf::Font& font)
+        : atlas(atlas), boardBatch(atlas), effects(maxParticles), scoreText(font, 28, sf::Color::Black) {
+        scoreText.addLabel("Score: ");
+        scoreField = scoreText.addNumber(10);
+        scoreText.addLabel("   High Score: ");
+        highScoreField = scoreText.addNumber(10);
+
+        scoreBox.setFillColor(sf::Color(255, 255, 255, 180));
+        scoreBox.setOutlineColor(sf::Color::Black);
+        scoreBox.setOutlineThickness(2);
+        centerScoreBar();
+    }
+
+    // The board as one textured quad (see gridshader.hpp), for giant levels.
+    // False, keeping the batch, when the driver has no shader support.
+    bool useShaderBoard() {
+        shaderBoard.reset(new ShaderBoard());
+        if (!ShaderBoard::isAvailable() || !shaderBoard->create()) shaderBoard.reset();
+        return shaderBoard != nullptr;
+    }
+
+    // Keeps the last frame and repaints only the cells that changed (see
+    // dirtyboard.hpp), for software OpenGL. Takes priority over the shader
+    // board.
+    bool useDirtyBoard(unsigned int w, unsigned int h, sf::Color background) {
+        dirtyBoard.reset(new DirtyBoard(atlas));
+        if (!dirtyBoard->create(w, h, background)) dirtyBoard.reset();
+        return dirtyBoard != nullptr;
+    }
+
+    // Slides the snake between cells (see smoothsnake.hpp), placed by
+    // draw()'s tickProgress. Only the sprite board draws it; the shader and
+    // dirty boards keep whole-cell moves.
+    void useSmoothSnake() { smoothSnake.reset(new SmoothSnake(atlas)); }
+    bool isSmooth() const { return smoothSnake && !shaderBoard && !dirtyBoard; }
+
+    // After a level or atlas change. Walls only change with the level, so
+    // their quads stay at the front of the batch.
+    void rebuild() {
+        boardBatch.clear();
+        for (int y = 0; y < gridRows; ++y)
+            for (int x = 0; x < gridCols; ++x)
+                if (wallGrid[y][x])
+                    boardBatch.add(SPRITE_WALL, x * blockSize, y * blockSize, blockSize - 2);
+        wallQuads = boardBatch.quadCount();
+        boardView = boardViewFor(gridCols, gridRows);
+        if (shaderBoard && !shaderBoard->reset(atlas)) shaderBoard.reset();
+        if (dirtyBoard) dirtyBoard->reset(boardView);
+        if (smoothSnake) smoothSnake->invalidate();
+    }
+
+    // Sparks over the board, in board coordinates; the game bursts and
+    // updates them, draw() shows them under the score bar.
+    ParticlePool& getEffects() { return effects; }
+
+    // True when draw() paints every pixel, so the target needn't be cleared.
+    bool coversTarget() const { return dirtyBoard != nullptr; }
+
+    // tickProgress is how far the current tick is through, for the smooth
+    // snake; every other board draws the snake where it is.
+    void draw(sf::RenderTarget& target, const Snake& snake, sf::Vector2i food, int score, int highScore, float tickProgress = 1.f) {
+        // Walls, snake and food in one draw call (two with the smooth snake)
+        if (dirtyBoard) {
+            dirtyBoard->update(snake, food);
+            target.draw(*dirtyBoard);
+            if (!effects.empty()) {
+                target.setView(boardView);
+                target.draw(effects);
+                target.setView(target.getDefaultView());
+            }
+        } else {
+            target.setView(boardView);
+            if (shaderBoard) {
+                shaderBoard->update(snake, food);
+                target.draw(*shaderBoard);
+            } else {
+                boardBatch.truncate(wallQuads);
+                if (!smoothSnake) addSnakeSprites(boardBatch, snake);
+                boardBatch.add(SPRITE_APPLE, food.x * blockSize, food.y * blockSize, blockSize - 2);
+                target.draw(boardBatch);
+                if (smoothSnake) {
+                    smoothSnake->update(snake, tickProgress);
+                    target.draw(*smoothSnake);
+                }
+            }
+            target.draw(effects);
+            target.setView(target.getDefaultView());
+        }
+
+        // --- Centered score and high score with boundary ---
+        // Only changed digits are rewritten (see hudtext.hpp); the bar is
+        // re-centered when its width changes.
+        bool resized = scoreText.setNumber(scoreField, score);
+        resized = scoreText.setNumber(highScoreField, highScore) || resized;
+        if (resized) centerScoreBar();
+
+        target.draw(scoreBox);
+        target.draw(scoreText);
+    }
+
+private:
+    void centerScoreBar() {
+        sf::FloatRect textRect = scoreText.getLocalBounds();
+        scoreText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
+        scoreText.setPosition(width / 2.0f, 20);
+
+        scoreBox.setSize(sf::Vector2f(textRect.width + 40, textRect.height + 20));
+        scoreBox.setOrigin(scoreBox.getSize().x / 2.0f, scoreBox.getSize().y / 2.0f);
+        scoreBox.setPosition(width / 2.0f, 20 + textRect.height / 2.0f);
+    }
+
+    const TextureAtlas& atlas;
+    SpriteBatch boardBatch;
+    size_t wallQuads = 0;
+    sf::View boardView;
+    std::unique_ptr<ShaderBoard> shaderBoard;
+    std::unique_ptr<DirtyBoard> dirtyBoard;
+    std::unique_ptr<SmoothSnake> smoothSnake;
+    ParticlePool effects;
+    HudText scoreText;
+    size_t scoreField = 0, highScoreField = 0;
+    sf::RectangleShape scoreBox;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "arena.hpp"
+#include "snapshot.hpp"
+
+// --- Client-side prediction ---
+// The own snake turns the moment the input is made instead of a round trip
+// later. Every local tick the client sends its input with a sequence number
+// and steps its own copy of the snake with the server's rules (steer() and
+// stepFrom()), remembering the outcome per input in a ring buffer. Every
+// snapshot echoes the newest input the server has applied: if the state
+// predicted for that input disagrees with the server's, the client rolls
+// back to the server's snake and replays the inputs still in flight.
+//
+// Only the own snake is predicted. Other snakes, apples and deaths come
+// straight from the snapshot; a predicted death would have to be taken back
+// far more often than it would help.
+class PredictedPlayer {
+public:
+    static constexpr std::uint32_t historySize = 64;  // 3.2 s of inputs at 20 Hz
+
+    struct Stats {
+        std::uint64_t steps = 0;
+        std::uint64_t corrections = 0;    // rollbacks caused by a misprediction
+        std::uint64_t replayedSteps = 0;  // inputs stepped again after a rollback
+    };
+
+    // One local tick, with the input just sent as seq.
+    void step(std::uint32_t seq, Direction wanted) {
+        Frame& frame = history[seq % historySize];
+        frame.seq = seq;
+        frame.input = wanted;
+        advance(frame);
+        newestSeq = seq;
+        stats.steps++;
+    }
+
+    void reconcile(const ArenaSnapshot& snap, int playerId) {
+        foods = snap.foods;
+        const SnapshotPlayer* me = nullptr;
+        for (const SnapshotPlayer& p : snap.players)
+            if (p.id == playerId) me = &p;
+        if (!me || !me->alive) {
+            alive = false;
+            body.clear();
+            return;
+        }
+
+        const std::uint32_t ack = snap.ackSeq;
+        const bool inHistory = ack <= newestSeq && newestSeq - ack < historySize;
+        const Frame& acked = history[ack % historySize];
+        if (alive && inHistory && acked.seq == ack && matches(acked, *me)) return;
+
+        // A respawn is not a misprediction: deaths are never predicted.
+        if (alive) stats.corrections++;
+        alive = true;
+        body = me->body;
+        dir = me->dir;
+        if (!inHistory) return;
+        for (std::uint32_t seq = ack + 1; seq <= newestSeq; ++seq) {
+            advance(history[seq % historySize]);
+            stats.replayedSteps++;
+        }
+    }
+
+    bool isAlive() const { return alive; }
+    Direction getDir() const { return dir; }
+    const std::deque<SnakeSegment>& getBody() const { return body; }
+    const Stats& getStats() const { return stats; }
+
+private:
+    struct Frame {
+        std::uint32_t seq = 0;
+        Direction input = Right;
+        // Predicted state after the input was applied.
+        bool alive = false;
+        Direction dir = Right;
+        SnakeSegment head{0, 0};
+        std::size_t length = 0;
+    };
+
+    // The same move as Arena::tick. An apple the server already knows about
+    // grows the snake; it is taken off the local list so a replay can't
+    // eat it twice.
+    void advance(Frame& frame) {
+        if (alive) {
+            dir = steer(dir, frame.input);
+            body.push_front(stepFrom(body.front(), dir));
+            bool ate = false;
+            for (size_t i = 0; i < foods.size() && !ate; ++i) {
+                if (foods[i].x == body.front().x && foods[i].y == body.front().y) {
+                    foods.erase(foods.begin() + i);
+                    ate = true;
+                }
+            }
+            if (!ate) body.pop_back();
+        }
+        frame.alive = alive;
+        frame.dir = dir;
+        frame.head = alive ? body.front() : SnakeSegment(0, 0);
+        frame.length = body.size();
+    }
+
+    static bool matches(const Frame& frame, const SnapshotPlayer& server) {
+        return frame.alive && frame.dir == server.dir && frame.length == server.body.size() &&
+               frame.head.x == server.body.front().x && frame.head.y == server.body.front().y;
+    }
+
+    Frame history[historySize];
+    std::uint32_t newestSeq = 0;
+    bool alive = false;
+    Direction dir = Right;
+    std::deque<SnakeSegment> body;
+    std::vector<sf::Vector2i> foods;
+    Stats stats;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "game.hpp"
+
+// --- Replays ---
+// A game is fully determined by its level, the endless seed, the seed its
+// food positions are drawn with and the direction in effect at every tick,
+// so that is all a replay stores: a short text header and one letter per
+// tick (U, D, L, R). Ten minutes at top speed is a few kilobytes.
+//
+//   serpent-replay 1
+//   level pillars.lvl        (Classic, Endless or a level file name)
+//   endless-seed 1712345678
+//   food-seed 99
+//   moves 3
+//   RRU
+struct Replay {
+    std::string level = "Classic";
+    std::uint32_t endlessSeed = 0;
+    std::uint32_t foodSeed = 0;
+    std::string moves;
+
+    void record(Direction d) { moves += "UDLR"[d]; }
+
+    Direction move(size_t tick) const {
+        switch (moves[tick]) {
+            case 'U': return Up;
+            case 'D': return Down;
+            case 'L': return Left;
+            default: return Right;
+        }
+    }
+
+    bool save(const std::string& path) const {
+        std::ofstream out(path);
+        out << "serpent-replay 1\nlevel " << level << "\nendless-seed " << endlessSeed << "\nfood-seed " << foodSeed
+            << "\nmoves " << moves.size() << "\n" << moves << "\n";
+        return static_cast<bool>(out);
+    }
+
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream in(path);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        std::string magic, key;
+        int version = 0;
+        size_t count = 0;
+        if (!(in >> magic >> version) || magic != "serpent-replay" || version != 1) {
+            error = "not a version 1 replay";
+            return false;
+        }
+        if (!(in >> key >> level) || key != "level" || !(in >> key >> endlessSeed) || key != "endless-seed" ||
+            !(in >> key >> foodSeed) || key != "food-seed" || !(in >> key >> count) || key != "moves") {
+            error = "bad header";
+            return false;
+        }
+        moves.clear();
+        if (count > 0 && !(in >> moves)) moves.clear();
+        if (moves.size() != count || moves.find_first_not_of("UDLR") != std::string::npos) {
+            error = "expected " + std::to_string(count) + " moves";
+            return false;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// --- Frame scheduler ---
+// PLAYING runs at a fixed tick rate through the window's framerate limit.
+// Every other state is idle: the loop blocks in waitEvent() and only redraws
+// when an event arrives, wakes at animationFps while something on screen is
+// still animating, or at pollFps while it only waits for work finished
+// elsewhere (a hot reload, a server answer) to show up.
+class FrameScheduler {
+public:
+    explicit FrameScheduler(unsigned int animationFps = 60, unsigned int pollFps = 10)
+        : animationFps(animationFps), pollFps(pollFps) {}
+
+    // Applies a framerate limit, touching the window only when it changes.
+    void setRate(sf::Window& window, unsigned int fps) {
+        if (fps == currentRate) return;
+        window.setFramerateLimit(fps);
+        currentRate = fps;
+    }
+
+    // Fetches the first event of a frame. Returns false when the frame should
+    // be drawn without an event (a fixed-rate tick or an animation timeout).
+    bool firstEvent(sf::Window& window, sf::Event& event, bool idle, bool animating, bool polling = false) {
+        // The first idle frame is always drawn so the new screen shows up
+        // before the loop starts blocking.
+        bool enteringIdle = idle && !wasIdle;
+        wasIdle = idle;
+        if (!idle) return window.pollEvent(event);
+
+        // Idle frames must not be throttled by the last tick rate, or each
+        // redraw after an event would sleep for a whole tick.
+        setRate(window, 0);
+        if (enteringIdle) return window.pollEvent(event);
+        if (!animating && !polling) return window.waitEvent(event);
+
+        // SFML 2.6 has no waitEvent timeout, so poll in short sleeps until
+        // the next frame is due.
+        sf::Time frame = sf::seconds(1.f / (animating ? animationFps : pollFps));
+        sf::Time slice = sf::milliseconds(2);
+        while (clock.getElapsedTime() < frame) {
+            if (window.pollEvent(event)) return true;
+            sf::sleep(slice);
+        }
+        clock.restart();
+        return false;
+    }
+
+private:
+    unsigned int animationFps;
+    unsigned int pollFps;
+    unsigned int currentRate = 0;
+    bool wasIdle = false;
+    sf::Clock clock;
+};
+
+// --- CPU report ---
+// CPU time of the whole process, every thread included. std::clock() is
+// wall time on Windows, so the process times are asked for there.
+inline double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    auto seconds = [](const FILETIME& t) {
+        return static_cast<double>((static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7;
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+// With --cpu-report: CPU use and frame rate per screen, on stderr. A line
+// covers one stay on a screen, or interval seconds of a long one. An idle
+// screen draws no frames while it waits, so its line comes out with the
+// first frame after the wait, covering the whole wait.
+class CpuReport {
+public:
+    explicit CpuReport(float interval = 5.f) : interval(interval), cpuStart(processCpuSeconds()) {}
+
+    // Call once per drawn frame.
+    void frame(const std::string& screen) {
+        if (screen != current) {
+            flush();
+            current = screen;
+        }
+        ++frames;
+        if (clock.getElapsedTime().asSeconds() >= interval) flush();
+    }
+
+private:
+    void flush() {
+        const float wall = clock.restart().asSeconds();
+        const double cpu = processCpuSeconds();
+        // Stays shorter than half a second are screen changes in passing.
+        if (!current.empty() && wall >= 0.5f)
+            std::cerr << "CPU: " << current << " " << 100.0 * (cpu - cpuStart) / wall << "% of one core, "
+                      << frames / wall << " frames/s over " << wall << " s\n";
+        cpuStart = cpu;
+        frames = 0;
+    }
+
+    float interval;
+    std::string current;
+    unsigned long long frames = 0;
+    double cpuStart;
+    sf::Clock clock;
+};
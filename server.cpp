@@ -0,0 +1,588 @@
+// serpent_server: headless authoritative arena server.
+//
+//   serpent_server [--port 53000] [--arenas 1] [--players 64] [--size 64]
+//                  [--tick 20] [--seconds 0] [--bots 0]
+//                  [--spectate-port 0] [--viewers 0]
+//   serpent_server --bandwidth-report
+//   serpent_server --latency-report
+//   serpent_server --snapshot-check
+//
+// Arena i listens on UDP port+i and runs on its own thread. --bots N starts
+// N scripted clients per arena on localhost (a load test); --seconds stops
+// after that long and prints per-arena statistics (0 runs until killed).
+// --spectate-port P streams arena i to read-only viewers on TCP P+i;
+// --viewers N connects N local viewers to each as a load test.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "net.hpp"
+#include "prediction.hpp"
+
+// --- Load-test bots ---
+// Picks a direction that doesn't kill the snake next tick, preferring the
+// nearest apple. Works from the last snapshot only, like a real client.
+static Direction chooseBotDirection(const ArenaSnapshot& snap, int playerId, int cols, int rows) {
+    const SnapshotPlayer* me = nullptr;
+    for (const SnapshotPlayer& p : snap.players)
+        if (p.id == playerId) me = &p;
+    if (!me || !me->alive || me->body.empty()) return Right;
+
+    const SnakeSegment head = me->body.front();
+    auto blocked = [&](int x, int y) {
+        if (x <= 0 || y <= 0 || x >= cols - 1 || y >= rows - 1) return true;
+        for (const SnapshotPlayer& p : snap.players)
+            for (const SnakeSegment& s : p.body)
+                if (s.x == x && s.y == y) return true;
+        return false;
+    };
+    sf::Vector2i target(head.x, head.y);
+    int best = -1;
+    for (const sf::Vector2i& f : snap.foods) {
+        int d = std::abs(f.x - head.x) + std::abs(f.y - head.y);
+        if (best < 0 || d < best) {
+            best = d;
+            target = f;
+        }
+    }
+
+    const Direction dirs[4] = { Up, Down, Left, Right };
+    const int dx[4] = { 0, 0, -1, 1 };
+    const int dy[4] = { -1, 1, 0, 0 };
+    Direction choice = me->dir;
+    int choiceScore = -1;
+    for (int d = 0; d < 4; ++d) {
+        int x = head.x + dx[d], y = head.y + dy[d];
+        if (blocked(x, y)) continue;
+        int score = 1000 - (std::abs(target.x - x) + std::abs(target.y - y));
+        if (score > choiceScore) {
+            choiceScore = score;
+            choice = dirs[d];
+        }
+    }
+    return choice;
+}
+
+static void runBots(unsigned short port, int count, int tickRate, const std::atomic<bool>& stop,
+                    std::atomic<std::uint64_t>& bytesReceived) {
+    std::vector<std::unique_ptr<NetClient>> bots;
+    for (int i = 0; i < count; ++i) {
+        std::unique_ptr<NetClient> bot(new NetClient());
+        if (bot->connect(sf::IpAddress::LocalHost, port)) bots.push_back(std::move(bot));
+    }
+    std::vector<ArenaSnapshot> snaps(bots.size());
+    while (!stop.load()) {
+        for (size_t i = 0; i < bots.size(); ++i) {
+            bots[i]->poll(snaps[i]);
+            bots[i]->sendInput(chooseBotDirection(snaps[i], bots[i]->getPlayerId(), bots[i]->getCols(), bots[i]->getRows()));
+        }
+        sf::sleep(sf::seconds(1.f / tickRate));
+    }
+    std::uint64_t total = 0;
+    for (auto& bot : bots) {
+        bot->leave();
+        total += bot->getBytesReceived();
+    }
+    bytesReceived += total;
+}
+
+// Local spectators for the load test, all polled from one thread.
+struct ViewerTotals {
+    std::atomic<std::uint64_t> connected{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> inSync{0};
+    std::atomic<std::uint64_t> cutOff{0};
+};
+
+static void runViewers(unsigned short port, int count, const std::atomic<bool>& stop, ViewerTotals& totals) {
+    std::vector<std::unique_ptr<SpectatorClient>> viewers;
+    for (int i = 0; i < count; ++i) {
+        std::unique_ptr<SpectatorClient> viewer(new SpectatorClient());
+        if (viewer->connect(sf::IpAddress::LocalHost, port)) viewers.push_back(std::move(viewer));
+    }
+    totals.connected += viewers.size();
+    std::vector<ArenaSnapshot> snaps(viewers.size());
+    while (!stop.load()) {
+        for (size_t i = 0; i < viewers.size(); ++i) viewers[i]->poll(snaps[i]);
+        sf::sleep(sf::milliseconds(5));
+    }
+    std::uint64_t bytes = 0, synced = 0, cut = 0;
+    for (size_t i = 0; i < viewers.size(); ++i) {
+        bytes += viewers[i]->getBytesReceived();
+        synced += snaps[i].valid;
+        cut += !viewers[i]->isConnected();
+    }
+    totals.bytes += bytes;
+    totals.inSync += synced;
+    totals.cutOff += cut;
+}
+
+// --- Bandwidth report ---
+// 64 snakes of a fixed length on a 1024x1024 board, laid out in stripes
+// with a free lane above each one to run along. Compares the old full
+// snapshot (4 bytes per segment) with deltas plus a keyframe every
+// SnapshotEncoder::keyframeInterval ticks.
+static std::size_t fullSnapshotBytes(const Arena& arena) {
+    std::size_t bytes = 13 + 4 * arena.foods.size();
+    for (const ArenaPlayer& p : arena.players) bytes += 12 + 4 * p.body.size();
+    return bytes;
+}
+
+static void printBandwidthReport(int tickRate) {
+    const int side = 1024;
+    const int players = 64;
+    const int ticks = static_cast<int>(SnapshotEncoder::keyframeInterval);
+    const std::size_t header = 9;  // type, tick, ackSeq
+    std::cout << "players " << players << ", board " << side << "x" << side << ", " << tickRate
+              << " Hz, keyframe every " << ticks << " ticks\n";
+    std::cout << std::setw(8) << "length" << std::setw(14) << "full KiB/s" << std::setw(14) << "delta B/tick"
+              << std::setw(14) << "keyframe B" << std::setw(8) << "parts" << std::setw(14) << "delta KiB/s" << "\n";
+    for (int length : { 10, 100, 1000, 10000 }) {
+        Arena arena(side, side, 99);
+        const int lane = side - 2;
+        const int stripe = (length + lane - 1) / lane + 1;
+        for (int i = 0; i < players; ++i) {
+            int id = arena.addPlayer();
+            int top = 1 + i * stripe;  // free lane; the body snakes below it
+            std::deque<SnakeSegment> body;
+            for (int k = 0; k < length; ++k) {
+                int row = k / lane, col = k % lane;
+                int x = row % 2 == 0 ? 1 + col : lane - col;
+                body.push_back(SnakeSegment(x, top + 1 + row));
+            }
+            arena.placeSnake(id, body, Up);
+        }
+
+        SnapshotEncoder encoder(arena);
+        encoder.encode(true);
+        std::size_t fullBytes = 0, deltaBytes = 0, keyBytes = 0;
+        for (int t = 0; t < ticks; ++t) {
+            arena.tick();
+            for (ArenaPlayer& p : arena.players) p.nextDir = Right;
+            encoder.encode(t == ticks - 1);
+            fullBytes += fullSnapshotBytes(arena) + header;
+            if (t < ticks - 1) deltaBytes += encoder.delta().size() + header;
+        }
+        // A keyframe over keyframePartBytes goes out as KEYFRAME_PARTs, each
+        // with its own header plus part and parts bytes.
+        const std::size_t keySize = encoder.keyframe().size();
+        const std::size_t parts = keySize > keyframePartBytes ? (keySize + keyframePartBytes - 1) / keyframePartBytes : 1;
+        keyBytes = keySize + (parts > 1 ? parts * (header + 2) : header);
+        double perTickDelta = static_cast<double>(deltaBytes) / (ticks - 1);
+        double fullRate = static_cast<double>(fullBytes) / ticks * tickRate / 1024.0;
+        double deltaRate = (perTickDelta * (ticks - 1) + keyBytes) / ticks * tickRate / 1024.0;
+        std::cout << std::setw(8) << length << std::setw(14) << fullRate << std::setw(14) << perTickDelta
+                  << std::setw(14) << keyBytes << std::setw(8) << parts << std::setw(14) << deltaRate << "\n";
+    }
+}
+
+// --- Snapshot round trip ---
+// Encodes a crowded arena every tick, decodes it as a client would and
+// compares the result with the arena itself; keyframes are checked on
+// their own as well. Players leave and join between ticks, often the last
+// one leaving and a newcomer taking its id on the same tick, and the board
+// is small enough that snakes regularly eat and die on one tick.
+static bool sameArena(const Arena& arena, const ArenaSnapshot& snap) {
+    if (!snap.valid || snap.tick != arena.getTick() || snap.foods != arena.foods || snap.players.size() != arena.players.size())
+        return false;
+    for (size_t i = 0; i < arena.players.size(); ++i) {
+        const ArenaPlayer& a = arena.players[i];
+        const SnapshotPlayer& s = snap.players[i];
+        if (s.id != a.id || s.alive != a.alive || s.score != static_cast<std::uint32_t>(a.score) ||
+            (a.alive && s.dir != a.dir) || s.body.size() != a.body.size())
+            return false;
+        for (size_t k = 0; k < a.body.size(); ++k)
+            if (s.body[k].x != a.body[k].x || s.body[k].y != a.body[k].y) return false;
+    }
+    return true;
+}
+
+static bool runSnapshotCheck(int ticks) {
+    Arena arena(24, 24, 5);
+    GameRng rng(11);
+    for (int i = 0; i < 8; ++i) arena.addPlayer();
+    SnapshotEncoder encoder(arena);
+    SnapshotDecoder decoder(arena.getCols(), arena.getRows());
+    ArenaSnapshot snap;
+    int joins = 0, leaves = 0, deltaErrors = 0, keyframeErrors = 0;
+    for (int t = 0; t < ticks; ++t) {
+        if (!arena.players.empty() && rng.below(10) == 0) {
+            arena.removePlayer(arena.players[rng.below(static_cast<int>(arena.players.size()))].id);
+            ++leaves;
+        }
+        if (!arena.players.empty() && rng.below(10) == 0) {
+            arena.removePlayer(arena.players.back().id);
+            arena.addPlayer();
+            ++leaves;
+            ++joins;
+        }
+        if (arena.players.size() < 12 && rng.below(8) == 0) {
+            arena.addPlayer();
+            ++joins;
+        }
+        for (const ArenaPlayer& p : arena.players)
+            if (rng.below(4) == 0) arena.setDirection(p.id, static_cast<Direction>(rng.below(4)));
+        arena.tick();
+
+        encoder.encode(!snap.valid);
+        if (snap.valid) {
+            BitReader bits(encoder.delta().data(), encoder.delta().size());
+            if (!decoder.applyDelta(bits, arena.getTick(), snap) || !sameArena(arena, snap)) {
+                ++deltaErrors;
+                snap.valid = false;
+            }
+        }
+        if (encoder.hasKeyframe()) {
+            ArenaSnapshot key;
+            BitReader bits(encoder.keyframe().data(), encoder.keyframe().size());
+            if (!decoder.readKeyframe(bits, arena.getTick(), key) || !sameArena(arena, key)) ++keyframeErrors;
+            else if (!snap.valid) snap = key;
+        }
+    }
+    std::cout << ticks << " ticks, " << joins << " joins, " << leaves << " leaves: " << deltaErrors
+              << " deltas and " << keyframeErrors << " keyframes decoded differently\n";
+    return deltaErrors == 0 && keyframeErrors == 0;
+}
+
+// --- Latency report ---
+// Sits between one client and the server on localhost and holds every
+// datagram for half the round trip, plus or minus half the jitter, in each
+// direction. Jitter delays packets but never reorders them, like a queue on
+// a busy link; optional loss drops them outright.
+class LagProxy {
+public:
+    LagProxy(unsigned short serverPort, int rttMs, int jitterMs, int lossPercent, std::uint32_t seed)
+        : serverPort(serverPort), rttMs(rttMs), jitterMs(jitterMs), lossPercent(lossPercent), rng(seed) {}
+
+    bool bind(unsigned short port) {
+        if (socket.bind(port, sf::IpAddress::LocalHost) != sf::Socket::Done) return false;
+        socket.setBlocking(false);
+        return true;
+    }
+
+    void run(const std::atomic<bool>& stop) {
+        sf::Clock clock;
+        std::vector<char> buffer(sf::UdpSocket::MaxDatagramSize);
+        while (!stop.load()) {
+            std::size_t size;
+            sf::IpAddress from;
+            unsigned short fromPort;
+            while (socket.receive(buffer.data(), buffer.size(), size, from, fromPort) == sf::Socket::Done) {
+                if (lossPercent > 0 && rng.below(100) < lossPercent) continue;
+                bool upstream = fromPort != serverPort;
+                if (upstream) clientPort = fromPort;
+                sf::Time& last = upstream ? lastUp : lastDown;
+                int oneWay = rttMs / 2 + (jitterMs > 0 ? rng.below(jitterMs + 1) - jitterMs / 2 : 0);
+                sf::Time due = std::max(last, clock.getElapsedTime() + sf::milliseconds(std::max(oneWay, 0)));
+                last = due;
+                queue.push_back({ due, upstream ? serverPort : clientPort, std::vector<char>(buffer.begin(), buffer.begin() + size) });
+            }
+            sf::Time now = clock.getElapsedTime();
+            for (size_t i = 0; i < queue.size();) {
+                if (queue[i].due > now) {
+                    ++i;
+                    continue;
+                }
+                socket.send(queue[i].bytes.data(), queue[i].bytes.size(), sf::IpAddress::LocalHost, queue[i].port);
+                queue.erase(queue.begin() + i);
+            }
+            sf::sleep(sf::milliseconds(1));
+        }
+    }
+
+private:
+    struct Datagram {
+        sf::Time due;
+        unsigned short port;
+        std::vector<char> bytes;
+    };
+
+    unsigned short serverPort;
+    unsigned short clientPort = 0;
+    int rttMs;
+    int jitterMs;
+    int lossPercent;
+    GameRng rng;
+    sf::UdpSocket socket;
+    std::vector<Datagram> queue;
+    sf::Time lastUp;
+    sf::Time lastDown;
+};
+
+// A scripted player behind the proxy. At random moments, independent of the
+// tick, it "presses" a turn, and then sooner whenever the cell ahead is
+// blocked. Perceived latency is the time from the press until the turn
+// shows: with prediction that is the next local tick, without it the first
+// snapshot in which the server has applied it.
+struct LatencyResult {
+    std::vector<double> predictedMs;
+    std::vector<double> serverMs;
+    PredictedPlayer::Stats prediction;
+    double seconds = 0;
+};
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+}
+
+static double mean(const std::vector<double>& values) {
+    double total = 0;
+    for (double v : values) total += v;
+    return values.empty() ? 0 : total / values.size();
+}
+
+static LatencyResult measureLatency(unsigned short proxyPort, float seconds, std::uint32_t seed) {
+    LatencyResult result;
+    NetClient client;
+    if (!client.connect(sf::IpAddress::LocalHost, proxyPort, sf::seconds(5))) return result;
+    const int cols = client.getCols(), rows = client.getRows(), id = client.getPlayerId();
+    const sf::Time tickLength = sf::seconds(1.f / client.getTickRate());
+
+    ArenaSnapshot snap;
+    PredictedPlayer predicted;
+    GameRng rng(seed);
+    Direction wanted = Right;
+    struct Press {
+        bool active = false;
+        bool shown = false;       // drawn by the prediction
+        std::uint32_t seq = 0;    // input that carried it, once sent
+        Direction dir = Right;
+        sf::Time at;
+    } press;
+
+    auto blocked = [&](int x, int y) {
+        if (x <= 0 || y <= 0 || x >= cols - 1 || y >= rows - 1) return true;
+        for (const SnakeSegment& s : predicted.getBody())
+            if (s.x == x && s.y == y) return true;
+        for (const SnapshotPlayer& p : snap.players) {
+            if (p.id == id) continue;
+            for (const SnakeSegment& s : p.body)
+                if (s.x == x && s.y == y) return true;
+        }
+        return false;
+    };
+
+    sf::Clock clock;
+    sf::Time nextTick = clock.getElapsedTime();
+    sf::Time nextPress = sf::milliseconds(500);
+    while (clock.getElapsedTime().asSeconds() < seconds) {
+        sf::Time now = clock.getElapsedTime();
+        if (client.poll(snap)) {
+            predicted.reconcile(snap, id);
+            if (press.active && press.seq && snap.ackSeq >= press.seq) {
+                for (const SnapshotPlayer& p : snap.players)
+                    if (p.id == id && p.alive && p.dir == press.dir)
+                        result.serverMs.push_back((now - press.at).asSeconds() * 1000.0);
+                press.active = false;
+            }
+        }
+
+        if (!press.active && predicted.isAlive()) {
+            const SnakeSegment head = predicted.getBody().front();
+            SnakeSegment ahead = stepFrom(head, predicted.getDir());
+            bool danger = blocked(ahead.x, ahead.y);
+            if (danger || now >= nextPress) {
+                const Direction dirs[2][2] = { { Left, Right }, { Up, Down } };
+                const Direction* turns = dirs[predicted.getDir() == Up || predicted.getDir() == Down ? 0 : 1];
+                int first = rng.below(2);
+                for (int k = 0; k < 2; ++k) {
+                    Direction d = turns[(first + k) % 2];
+                    SnakeSegment next = stepFrom(head, d);
+                    if (blocked(next.x, next.y)) continue;
+                    press = Press();
+                    press.active = true;
+                    press.dir = d;
+                    press.at = now;
+                    wanted = d;
+                    break;
+                }
+                nextPress = now + sf::milliseconds(200 + rng.below(600));
+            }
+        }
+
+        if (now >= nextTick) {
+            std::uint32_t seq = client.sendInput(wanted);
+            predicted.step(seq, wanted);
+            if (press.active && !press.seq) {
+                press.seq = seq;
+                if (predicted.isAlive() && predicted.getDir() == press.dir) {
+                    press.shown = true;
+                    result.predictedMs.push_back((now - press.at).asSeconds() * 1000.0);
+                }
+            }
+            nextTick += tickLength;
+        }
+        sf::sleep(sf::milliseconds(1));
+    }
+    client.leave();
+    result.prediction = predicted.getStats();
+    result.seconds = seconds;
+    return result;
+}
+
+static void printLatencyReport(int tickRate) {
+    struct Link {
+        int rttMs, jitterMs, lossPercent;
+    };
+    const Link links[] = { { 0, 0, 0 }, { 50, 10, 0 }, { 100, 20, 0 }, { 200, 40, 0 }, { 100, 20, 5 } };
+    const float seconds = 10;
+    std::cout << "one client behind a lag proxy, 8 bots, 48x48 board, " << tickRate << " Hz, " << seconds
+              << " s per link; perceived input latency in ms\n";
+    std::cout << std::setw(6) << "rtt" << std::setw(8) << "jitter" << std::setw(6) << "loss" << std::setw(8) << "turns"
+              << std::setw(14) << "predicted" << std::setw(8) << "p95" << std::setw(14) << "server only"
+              << std::setw(8) << "p95" << std::setw(14) << "rollbacks/s" << "\n";
+    unsigned short port = 53200;
+    for (const Link& link : links) {
+        ArenaServer server(48, 48, 16, tickRate, 4321u);
+        LagProxy proxy(port, link.rttMs, link.jitterMs, link.lossPercent, 77u);
+        if (!server.bind(port, sf::IpAddress::LocalHost) || !proxy.bind(static_cast<unsigned short>(port + 1))) {
+            std::cerr << "cannot bind UDP ports " << port << "-" << port + 1 << "\n";
+            return;
+        }
+        std::atomic<bool> stop(false);
+        std::atomic<std::uint64_t> botBytes(0);
+        std::thread serverThread([&] { server.run(stop); });
+        std::thread proxyThread([&] { proxy.run(stop); });
+        std::thread botThread([&] { runBots(port, 8, tickRate, stop, botBytes); });
+        LatencyResult r = measureLatency(static_cast<unsigned short>(port + 1), seconds, 99u);
+        stop.store(true);
+        botThread.join();
+        proxyThread.join();
+        serverThread.join();
+        port = static_cast<unsigned short>(port + 2);
+
+        std::cout << std::setw(6) << link.rttMs << std::setw(8) << link.jitterMs << std::setw(5) << link.lossPercent
+                  << "%" << std::setw(8) << r.predictedMs.size() << std::setw(14) << mean(r.predictedMs)
+                  << std::setw(8) << percentile(r.predictedMs, 0.95) << std::setw(14) << mean(r.serverMs)
+                  << std::setw(8) << percentile(r.serverMs, 0.95) << std::setw(14)
+                  << (r.seconds > 0 ? r.prediction.corrections / r.seconds : 0.0) << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "--bandwidth-report") == 0) {
+        std::cout << std::fixed << std::setprecision(1);
+        printBandwidthReport(20);
+        return 0;
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--snapshot-check") == 0) {
+        return runSnapshotCheck(3000) ? 0 : 1;
+    }
+    if (argc >= 2 && std::strcmp(argv[1], "--latency-report") == 0) {
+        std::cout << std::fixed << std::setprecision(1);
+        printLatencyReport(20);
+        return 0;
+    }
+
+    int port = defaultServerPort;
+    int arenas = 1;
+    int players = 64;
+    int size = 64;
+    int tickRate = 20;
+    int seconds = 0;
+    int bots = 0;
+    int spectatePort = 0;
+    int viewers = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        int value = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--port") == 0) port = value;
+        else if (std::strcmp(argv[i], "--arenas") == 0) arenas = value;
+        else if (std::strcmp(argv[i], "--players") == 0) players = value;
+        else if (std::strcmp(argv[i], "--size") == 0) size = value;
+        else if (std::strcmp(argv[i], "--tick") == 0) tickRate = value;
+        else if (std::strcmp(argv[i], "--seconds") == 0) seconds = value;
+        else if (std::strcmp(argv[i], "--bots") == 0) bots = value;
+        else if (std::strcmp(argv[i], "--spectate-port") == 0) spectatePort = value;
+        else if (std::strcmp(argv[i], "--viewers") == 0) viewers = value;
+        else {
+            std::cerr << "unknown option " << argv[i] << "\n";
+            return 1;
+        }
+    }
+    if (viewers > 0 && spectatePort == 0) spectatePort = port + 100;
+    if (arenas < 1 || players < 1 || size < 8 || size > maxArenaSide || tickRate < 1 || tickRate > 255) {
+        std::cerr << "bad arguments\n";
+        return 1;
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<std::unique_ptr<ArenaServer>> servers;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < arenas; ++i) {
+        std::unique_ptr<ArenaServer> server(new ArenaServer(size, size, players, tickRate, 1234u + i));
+        // The load test never leaves the machine.
+        sf::IpAddress address = bots > 0 || viewers > 0 ? sf::IpAddress::LocalHost : sf::IpAddress::Any;
+        if (!server->bind(static_cast<unsigned short>(port + i), address)) {
+            std::cerr << "cannot bind UDP port " << port + i << "\n";
+            return 1;
+        }
+        if (spectatePort > 0 && !server->listenSpectators(static_cast<unsigned short>(spectatePort + i), address)) {
+            std::cerr << "cannot listen on TCP port " << spectatePort + i << "\n";
+            return 1;
+        }
+        servers.push_back(std::move(server));
+    }
+    for (auto& server : servers) {
+        ArenaServer* s = server.get();
+        threads.emplace_back([s, &stop] { s->run(stop); });
+    }
+    std::cout << arenas << " arena(s) of " << size << "x" << size << " on UDP " << port << "-" << port + arenas - 1
+              << ", " << tickRate << " Hz, up to " << players << " players each\n";
+    if (spectatePort > 0)
+        std::cout << "spectators on TCP " << spectatePort << "-" << spectatePort + arenas - 1 << "\n";
+
+    std::atomic<std::uint64_t> botBytes(0);
+    std::vector<std::thread> botThreads;
+    for (int i = 0; i < arenas && bots > 0; ++i) {
+        unsigned short arenaPort = static_cast<unsigned short>(port + i);
+        botThreads.emplace_back([arenaPort, bots, tickRate, &stop, &botBytes] { runBots(arenaPort, bots, tickRate, stop, botBytes); });
+    }
+    ViewerTotals viewerTotals;
+    for (int i = 0; i < arenas && viewers > 0; ++i) {
+        unsigned short viewPort = static_cast<unsigned short>(spectatePort + i);
+        botThreads.emplace_back([viewPort, viewers, &stop, &viewerTotals] { runViewers(viewPort, viewers, stop, viewerTotals); });
+    }
+
+    if (seconds <= 0) {
+        for (auto& t : threads) t.join();
+        return 0;
+    }
+    sf::sleep(sf::seconds(static_cast<float>(seconds)));
+    stop.store(true);
+    for (auto& t : botThreads) t.join();
+    for (auto& t : threads) t.join();
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (int i = 0; i < arenas; ++i) {
+        const ArenaServer::Stats& s = servers[i]->getStats();
+        double ticks = static_cast<double>(std::max<std::uint64_t>(s.ticks, 1));
+        double perPlayer = s.peakClients ? static_cast<double>(s.bytesSent) / s.peakClients / seconds / 1024.0 : 0.0;
+        std::cout << "arena " << i << ": " << s.ticks << " ticks, " << s.peakClients << " clients, tick mean "
+                  << s.tickSecondsTotal / ticks * 1000.0 << " ms, max " << s.tickSecondsMax * 1000.0
+                  << " ms, out " << perPlayer << " KiB/s per player";
+        if (s.splitKeyframes) std::cout << ", " << s.splitKeyframes << " keyframes split";
+        if (s.oversized) std::cout << ", " << s.oversized << " oversized packets dropped";
+        std::cout << "\n";
+        const SpectatorHub::Stats& v = servers[i]->getSpectatorStats();
+        if (v.accepted)
+            std::cout << "  spectators: " << v.accepted << " accepted, " << v.dropped << " dropped, peak " << v.peakViewers
+                      << ", out " << v.bytesSent / 1024 << " KiB\n";
+    }
+    if (bots > 0)
+        std::cout << "bots received " << botBytes.load() / 1024 << " KiB in total\n";
+    if (viewers > 0)
+        std::cout << viewerTotals.connected.load() << " viewers received " << viewerTotals.bytes.load() / 1024 << " KiB, "
+                  << viewerTotals.inSync.load() << " in sync at the end, " << viewerTotals.cutOff.load() << " cut off\n";
+    return 0;
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "atlas.hpp"
+#include "game.hpp"
+
+// --- Smooth snake ---
+// Draws the snake sliding between cells at the display's refresh rate
+// instead of jumping a cell per tick. The snake's path runs through the
+// middle of its cells, straight or as a quarter circle round the inside
+// corner of a turn. It is drawn as one triangle strip, a cell wide, with
+// the body sprite stretched along it. The head and tail sprites cover the
+// cell-length stretch around two points that move along the path as the
+// tick goes on. The head's cell bends towards snake.dir as soon as it
+// changes, so the head turns with the key press rather than a tick later.
+//
+// The strip is kept from frame to frame. A tick appends the new head cell,
+// bends the old one into a turn if needed and drops the cell the tail has
+// left; a frame only rewrites the vertices under the head and the tail.
+// Only a new snake (new game, new level) is built from snake.body.
+// `SerpentRush --smooth-check` compares every frame with a fresh build.
+class SmoothSnake : public sf::Drawable {
+public:
+    explicit SmoothSnake(const TextureAtlas& atlas) : atlas(atlas) {}
+
+    // progress is how far into the current tick the frame is, 0 to 1: at 0
+    // the snake is drawn where the last move started, at 1 where it is now.
+    void update(const Snake& snake, float progress) {
+        restore(tailSlots);
+        restore(headSlots);
+        if (rewriteAll) {
+            writeFrom(sampleBase);
+            rewriteAll = false;
+        }
+        const size_t n = snake.body.size();
+        const SnakeSegment& head = snake.body.front();
+        if (cells.empty()) {
+            rebuild(snake);
+        } else if (n == length && same(head, cells.back().at)) {
+            // No tick since the last frame.
+        } else if ((n > 1 ? same(snake.body[1], cells.back().at) : adjacent(head, cells.back().at)) &&
+                   (n == length || n == length + 1) && !opposite(cells.back().in, directionTo(cells.back().at, head))) {
+            advance(head, n == length + 1);
+        } else {
+            rebuild(snake);
+        }
+        steer(snake.dir);
+        layout(std::min(std::max(progress, 0.f), 1.f));
+    }
+
+    // After an atlas change: every vertex is rewritten on the next update().
+    void invalidate() { rewriteAll = true; }
+
+    // The vertices draw() submits.
+    const sf::Vertex* drawnVertices(size_t& count) const {
+        count = drawCount;
+        return drawCount ? &strip[drawFirst] : nullptr;
+    }
+
+private:
+    // Turns are quarter circles of arcSegments; straight cells need only
+    // their two ends. slack is the room kept free before the first and
+    // after the last sample for the head and tail pieces.
+    static constexpr int arcSegments = 6;
+    static constexpr size_t slack = 2 * (arcSegments + 1) + 8;
+
+    struct Cell {
+        SnakeSegment at;
+        Direction in, out;  // travel direction entering and leaving the cell
+        size_t first;       // first sample, counted from the start of the game
+        size_t count;
+    };
+
+    struct Sample {
+        sf::Vector2f pos;
+        sf::Vector2f side;  // half a cell to the left of travel
+        float along;        // 0 at the cell's entry edge, 1 at its exit
+    };
+
+    static bool same(const SnakeSegment& a, const SnakeSegment& b) { return a.x == b.x && a.y == b.y; }
+
+    static bool adjacent(const SnakeSegment& a, const SnakeSegment& b) { return std::abs(a.x - b.x) + std::abs(a.y - b.y) == 1; }
+
+    static bool opposite(Direction a, Direction b) {
+        return (a == Up && b == Down) || (a == Down && b == Up) || (a == Left && b == Right) || (a == Right && b == Left);
+    }
+
+    static sf::Vector2f unit(Direction d) {
+        switch (d) {
+            case Up: return sf::Vector2f(0, -1);
+            case Down: return sf::Vector2f(0, 1);
+            case Left: return sf::Vector2f(-1, 0);
+            default: return sf::Vector2f(1, 0);
+        }
+    }
+
+    // The point a fraction u through a cell's path, and the half-width
+    // vector to its left.
+    static void pointAt(const Cell& cell, float u, sf::Vector2f& pos, sf::Vector2f& side) {
+        const float half = blockSize / 2.f;
+        const sf::Vector2f center((cell.at.x + 0.5f) * blockSize, (cell.at.y + 0.5f) * blockSize);
+        const sf::Vector2f in = unit(cell.in), out = unit(cell.out);
+        sf::Vector2f tangent = in;
+        if (cell.in == cell.out) {
+            pos = center + in * (half * (2 * u - 1));
+        } else {
+            // Round the corner shared by the entry and exit edges.
+            const sf::Vector2f corner = center + (out - in) * half;
+            const float angle = u * 3.14159265f / 2;
+            pos = corner + (in * std::sin(angle) - out * std::cos(angle)) * half;
+            tangent = in * std::cos(angle) + out * std::sin(angle);
+        }
+        side = sf::Vector2f(tangent.y, -tangent.x) * half;
+    }
+
+    size_t slotOf(size_t sample) const { return sample - sampleBase + slack; }
+
+    void appendCell(SnakeSegment at, Direction in, Direction out) {
+        Cell cell{at, in, out, sampleBase + samples.size(), in == out ? 2u : static_cast<size_t>(arcSegments + 1)};
+        for (size_t i = 0; i < cell.count; ++i) {
+            Sample s;
+            s.along = static_cast<float>(i) / (cell.count - 1);
+            pointAt(cell, s.along, s.pos, s.side);
+            samples.push_back(s);
+        }
+        cells.push_back(cell);
+    }
+
+    // Two strip vertices across the path, textured with the sprite's column
+    // u of the way along it. Columns stay half a texel inside the sprite so
+    // smoothing doesn't pull in the atlas padding where textures change.
+    void pair(sf::Vertex* out, sf::Vector2f pos, sf::Vector2f side, SpriteId sprite, float u) const {
+        const sf::IntRect r = atlas.getRect(sprite);
+        const float x = r.left + 0.5f + u * (r.width - 1);
+        out[0] = sf::Vertex(pos + side, sf::Vector2f(x, static_cast<float>(r.top)));
+        out[1] = sf::Vertex(pos - side, sf::Vector2f(x, static_cast<float>(r.top + r.height)));
+    }
+
+    void putPair(size_t slot, const Sample& s) { pair(&strip[slot * 2], s.pos, s.side, SPRITE_SNAKE_BODY, s.along); }
+
+    void pushPair(sf::Vector2f pos, sf::Vector2f side, SpriteId sprite, float u) {
+        scratch.resize(scratch.size() + 2);
+        pair(&scratch[scratch.size() - 2], pos, side, sprite, u);
+    }
+
+    // Writes the body vertices of every sample from the given one on.
+    void writeFrom(size_t sample) {
+        strip.resize((samples.size() + 2 * slack) * 2);
+        for (size_t i = sample; i < sampleBase + samples.size(); ++i) {
+            putPair(slotOf(i), samples[i - sampleBase]);
+        }
+    }
+
+    void rebuild(const Snake& snake) {
+        const std::vector<SnakeSegment>& body = snake.body;
+        const size_t n = body.size();
+        cells.clear();
+        samples.clear();
+        sampleBase = 0;
+        for (size_t i = n; i-- > 0;) {
+            Direction out = i > 0 ? directionTo(body[i], body[i - 1]) : snake.dir;
+            Direction in = i + 1 < n ? directionTo(body[i + 1], body[i]) : out;
+            appendCell(body[i], in, out);
+        }
+        writeFrom(0);
+        length = n;
+        retired = false;
+        moving = false;
+    }
+
+    // Replaces the head cell with one leaving in another direction.
+    void reshapeHead(Direction out) {
+        const Cell head = cells.back();
+        cells.pop_back();
+        samples.resize(head.first - sampleBase);
+        appendCell(head.at, head.in, out);
+    }
+
+    void steer(Direction dir) {
+        if (cells.back().out == dir || opposite(cells.back().in, dir)) return;
+        reshapeHead(dir);
+        writeFrom(cells.back().first);
+    }
+
+    // One tick: the head moved onto a new cell and the tail followed unless
+    // the snake grew. The cell the tail leaves is kept for one more tick,
+    // since the tail is still sliding out of it.
+    void advance(SnakeSegment head, bool grew) {
+        const Direction d = directionTo(cells.back().at, head);
+        const size_t neck = cells.back().first;
+        reshapeHead(d);
+        appendCell(head, d, d);
+        if (retired) cells.pop_front();
+        retired = !grew;
+        length += grew ? 1 : 0;
+        moving = true;
+
+        // Drop samples behind the tail once they are half the buffer.
+        const size_t dead = cells.front().first - sampleBase;
+        if (dead > 64 && dead * 2 > samples.size()) {
+            samples.erase(samples.begin(), samples.begin() + dead);
+            strip.erase(strip.begin() + slack * 2, strip.begin() + (slack + dead) * 2);
+            sampleBase += dead;
+        }
+        writeFrom(neck);
+    }
+
+    // Puts back the body vertices a head or tail piece covered last frame.
+    // The tail only moves forward, so for it this is a safeguard.
+    void restore(std::pair<size_t, size_t>& slots) {
+        const size_t end = std::min(slots.second, slotOf(sampleBase + samples.size()));
+        for (size_t slot = std::max(slots.first, slack); slot < end; ++slot) {
+            putPair(slot, samples[slot - slack]);
+        }
+        slots = std::make_pair(0, 0);
+    }
+
+    // Cell index and fraction for a position g along the path, counted in
+    // cells from the front of the deque. At a cell boundary, atEnd picks
+    // the end of the earlier cell over the start of the later one.
+    void locate(float g, bool atEnd, size_t& cell, float& u) const {
+        float whole = std::floor(g);
+        if (atEnd && whole == g && whole > 0) whole -= 1;
+        whole = std::min(std::max(whole, 0.f), static_cast<float>(cells.size() - 1));
+        cell = static_cast<size_t>(whole);
+        u = std::min(std::max(g - whole, 0.f), 1.f);
+    }
+
+    void pairAt(float g, bool atEnd, SpriteId sprite, float spriteU, bool bodyU) {
+        size_t cell;
+        float u;
+        locate(g, atEnd, cell, u);
+        sf::Vector2f pos, side;
+        pointAt(cells[cell], u, pos, side);
+        pushPair(pos, side, sprite, bodyU ? u : spriteU);
+    }
+
+    // Samples strictly between two positions, mapped onto a sprite that
+    // spans exactly that stretch.
+    void pairsBetween(float from, float to, SpriteId sprite) {
+        for (size_t c = static_cast<size_t>(std::max(from, 0.f)); c < cells.size() && c <= to; ++c) {
+            const Cell& cell = cells[c];
+            for (size_t i = 0; i < cell.count; ++i) {
+                const Sample& s = samples[cell.first + i - sampleBase];
+                const float g = c + s.along;
+                if (g <= from || g >= to) continue;
+                pushPair(s.pos, s.side, sprite, (g - from) / (to - from));
+            }
+        }
+    }
+
+    // First sample at or (strictly) after position g.
+    size_t sampleFrom(float g, bool strictly) const {
+        size_t c = static_cast<size_t>(std::min(std::max(std::floor(g), 0.f), static_cast<float>(cells.size() - 1)));
+        for (; c < cells.size(); ++c) {
+            const Cell& cell = cells[c];
+            for (size_t i = 0; i < cell.count; ++i) {
+                const float at = c + samples[cell.first + i - sampleBase].along;
+                if (strictly ? at > g : at >= g) return cell.first + i;
+            }
+        }
+        return sampleBase + samples.size();
+    }
+
+    // Writes the tail piece just before the body's vertices and the head
+    // piece just after them, each joined on with a zero-width pair where
+    // the texture changes, and sets the range to draw.
+    void layout(float progress) {
+        const float a = moving ? progress : 1.f;
+        const float head = cells.size() - 1.5f + a;
+        const float tail = retired ? 0.5f + a : 0.5f;
+        const bool hasTail = length > 1;
+
+        size_t bodyBegin = sampleFrom(tail + 0.5f, true);
+        size_t bodyEnd = std::max(sampleFrom(head - 0.5f, false), bodyBegin);
+        if (!hasTail) bodyBegin = bodyEnd;
+
+        size_t first = slotOf(bodyBegin);
+        if (hasTail) {
+            scratch.clear();
+            pairAt(tail - 0.5f, false, SPRITE_SNAKE_TAIL, 0, false);
+            pairsBetween(tail - 0.5f, tail + 0.5f, SPRITE_SNAKE_TAIL);
+            pairAt(tail + 0.5f, true, SPRITE_SNAKE_TAIL, 1, false);
+            pairAt(tail + 0.5f, false, SPRITE_SNAKE_BODY, 0, true);
+            first -= scratch.size() / 2;
+            std::copy(scratch.begin(), scratch.end(), strip.begin() + first * 2);
+            tailSlots = std::make_pair(first, slotOf(bodyBegin));
+        }
+
+        scratch.clear();
+        pairAt(head - 0.5f, true, SPRITE_SNAKE_BODY, 0, true);
+        pairAt(head - 0.5f, false, SPRITE_SNAKE_HEAD, 0, false);
+        pairsBetween(head - 0.5f, head + 0.5f, SPRITE_SNAKE_HEAD);
+        pairAt(head + 0.5f, true, SPRITE_SNAKE_HEAD, 1, false);
+        std::copy(scratch.begin(), scratch.end(), strip.begin() + slotOf(bodyEnd) * 2);
+        headSlots = std::make_pair(slotOf(bodyEnd), slotOf(bodyEnd) + scratch.size() / 2);
+
+        drawFirst = first * 2;
+        drawCount = (headSlots.second - first) * 2;
+    }
+
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override {
+        if (drawCount == 0) return;
+        states.texture = &atlas.getTexture();
+        target.draw(&strip[drawFirst], drawCount, sf::TriangleStrip, states);
+    }
+
+    const TextureAtlas& atlas;
+    std::deque<Cell> cells;        // the retired tail cell (if any), tail ... head
+    std::vector<Sample> samples;   // sample i is samples[i - sampleBase]
+    size_t sampleBase = 0;
+    std::vector<sf::Vertex> strip;  // two per sample, slack pairs either side
+    std::vector<sf::Vertex> scratch;
+    size_t length = 0;       // snake.body.size() at the last tick
+    bool retired = false;    // the front cell is one the tail is leaving
+    bool moving = false;     // false until the first tick after a rebuild
+    bool rewriteAll = false;
+    std::pair<size_t, size_t> tailSlots, headSlots;  // written over last frame
+    size_t drawFirst = 0, drawCount = 0;
+};
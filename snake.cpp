@@ -4,198 +4,276 @@
 #include <cstdlib>
 #include <ctime>
 #include <stack>
-
-const int blockSize = 20;
-const int width = 800;
-const int height = 600;
-
-// --- Snake segment struct ---
-struct SnakeSegment {
-    int x, y;
-    SnakeSegment(int x, int y) : x(x), y(y) {}
-};
-
-enum Direction { Up, Down, Left, Right };
-enum GameState { MENU, PLAYING, PAUSED, GAMEOVER, HIGHSCORES };
-
-// --- Snake class ---
-class Snake {
-public:
-    std::vector<SnakeSegment> body;
-    Direction dir;
-
-    Snake() {
-        body.push_back(SnakeSegment(width / (2 * blockSize), height / (2 * blockSize)));
-        dir = Right;
-    }
-
-    void move() {
-        SnakeSegment head = body.front();
-        switch (dir) {
-            case Up: head.y--; break;
-            case Down: head.y++; break;
-            case Left: head.x--; break;
-            case Right: head.x++; break;
-        }
-        body.insert(body.begin(), head);
-        body.pop_back();
-    }
-
-    void grow() {
-        SnakeSegment head = body.front();
-        switch (dir) {
-            case Up: head.y--; break;
-            case Down: head.y++; break;
-            case Left: head.x--; break;
-            case Right: head.x++; break;
-        }
-        body.insert(body.begin(), head);
-    }
-
-    bool checkCollision() {
-        SnakeSegment head = body.front();
-        if (head.x < 0 || head.y < 0 || head.x * blockSize >= width || head.y * blockSize >= height)
-            return true;
-        for (size_t i = 1; i < body.size(); i++) {
-            if (body[i].x == head.x && body[i].y == head.y)
-                return true;
-        }
-        return false;
-    }
-};
-
-// --- Wall grid and setup ---
-const int gridCols = width / blockSize;
-const int gridRows = height / blockSize;
-std::vector<std::vector<bool>> wallGrid(gridRows, std::vector<bool>(gridCols, false));
-
-void setupWalls() {
-    for (int i = 0; i < gridCols; ++i) {
-        wallGrid[0][i] = true;
-        wallGrid[gridRows-1][i] = true;
-    }
-    for (int i = 0; i < gridRows; ++i) {
-        wallGrid[i][0] = true;
-        wallGrid[i][gridCols-1] = true;
-    }
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <sstream>
+#include <filesystem>
+
+#include "game.hpp"
+#include "level.hpp"
+#include "levelgen.hpp"
+#include "hotreload.hpp"
+#include "leaderboard.hpp"
+#include "assets.hpp"
+#include "atlas.hpp"
+#include "playfield.hpp"
+#include "replay.hpp"
+#include "capture.hpp"
+#include "layer.hpp"
+#include "mixer.hpp"
+#include "scheduler.hpp"
+#include "ui.hpp"
+
+// --- Smooth snake check ---
+// SmoothSnake keeps its strip from frame to frame and only patches it.
+// --smooth-check runs random walks through two SmoothSnakes that get the
+// same frames, a few per tick, with turns pressed mid-tick. The second one
+// is invalidated before every frame, so it writes every vertex from
+// scratch. The two must draw the same strip, and the strip must have no
+// gaps. That covers the trimming in advance(), slotOf() after it, and
+// restore() putting back the cells under last frame's head and tail.
+// Walks may cross themselves: only the drawing is checked.
+static bool sameStrip(const SmoothSnake& patched, const SmoothSnake& rewritten) {
+    size_t count, expected;
+    const sf::Vertex* v = patched.drawnVertices(count);
+    const sf::Vertex* w = rewritten.drawnVertices(expected);
+    if (count != expected) return false;
+    auto near = [](sf::Vector2f p, sf::Vector2f q, float limit) { return std::abs(p.x - q.x) < limit && std::abs(p.y - q.y) < limit; };
+    for (size_t i = 0; i < count; ++i)
+        if (!near(v[i].position, w[i].position, 1e-3f) || !near(v[i].texCoords, w[i].texCoords, 1e-3f)) return false;
+    // Consecutive pairs' centres are never more than a cell apart.
+    for (size_t i = 2; i + 1 < count; i += 2)
+        if (!near((v[i].position + v[i + 1].position) / 2.f, (v[i - 2].position + v[i - 1].position) / 2.f, blockSize * 1.01f))
+            return false;
+    return true;
 }
 
-// --- Food generation ---
-sf::Vector2i generateFoodPosition(const Snake& snake) {
-    sf::Vector2i pos;
-    bool invalid;
-    do {
-        invalid = false;
-        pos.x = rand() % gridCols;
-        pos.y = rand() % gridRows;
-        if (wallGrid[pos.y][pos.x]) {
-            invalid = true;
-            continue;
-        }
-        for (const auto& segment : snake.body) {
-            if (segment.x == pos.x && segment.y == pos.y) {
-                invalid = true;
-                break;
+static bool runSmoothCheck(int games, int ticks) {
+    setupWalls();
+    TextureAtlas atlas;
+    if (!buildGameAtlas(atlas, nullptr, nullptr)) return false;
+    srand(7);
+    SmoothSnake patched(atlas), rewritten(atlas);
+    long frames = 0, errors = 0;
+    size_t longest = 0;
+    for (int game = 0; game < games; ++game) {
+        Snake snake;
+        // Inside the border walls, and never back along the last move.
+        auto allowed = [&](Direction d) {
+            SnakeSegment head = snake.body.front();
+            head.x += d == Right ? 1 : d == Left ? -1 : 0;
+            head.y += d == Down ? 1 : d == Up ? -1 : 0;
+            bool back = snake.body.size() > 1 && head.x == snake.body[1].x && head.y == snake.body[1].y;
+            return !back && head.x >= 1 && head.y >= 1 && head.x < gridCols - 1 && head.y < gridRows - 1;
+        };
+        for (int t = 0; t < ticks; ++t) {
+            const int frameCount = 1 + rand() % 4;
+            for (int f = 0; f < frameCount; ++f) {
+                Direction press = static_cast<Direction>(rand() % 4);
+                if (rand() % 3 == 0 && allowed(press)) snake.dir = press;
+                const float progress = static_cast<float>(f) / frameCount;
+                patched.update(snake, progress);
+                rewritten.invalidate();
+                rewritten.update(snake, progress);
+                if (!sameStrip(patched, rewritten)) ++errors;
+                ++frames;
             }
+            // A key handled in the same loop pass as the tick bends the
+            // head only at the tick.
+            Direction press = static_cast<Direction>(rand() % 4);
+            if (rand() % 3 == 0 && allowed(press)) snake.dir = press;
+            for (int k = 0; k < 16 && !allowed(snake.dir); ++k) snake.dir = static_cast<Direction>(rand() % 4);
+            if (!allowed(snake.dir)) break;
+            if (rand() % 10 == 0) snake.grow();
+            else snake.move();
+            longest = std::max(longest, snake.body.size());
         }
-    } while (invalid);
-    return pos;
-}
-
-// --- Button hover helper ---
-bool isMouseOver(const sf::RectangleShape& rect, sf::Vector2f mousePos) {
-    return rect.getGlobalBounds().contains(mousePos);
+    }
+    std::cout << "smooth snake: " << games << " walks, " << frames << " frames, longest snake " << longest << ", " << errors
+              << " frames differ from a full rewrite\n";
+    return errors == 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    sf::Clock startupClock;
+    if (argc >= 2 && std::strcmp(argv[1], "--smooth-check") == 0)
+        return runSmoothCheck(50, 2000) ? 0 : 1;
     srand(static_cast<unsigned>(time(nullptr)));
     setupWalls();
 
-    sf::RenderWindow window(sf::VideoMode(width, height), "Serpent Rush");
-    int baseSpeed = 5;
+    // --- Replay export (headless) ---
+    // --export-replay FILE plays a recorded game back offscreen and writes
+    // it as --fps frames per second: PNGs into --png DIR, or raw RGBA on
+    // stdout. No window is opened.
+    std::string exportPath, pngDir;
+    unsigned int exportFps = 30;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--export-replay") == 0) exportPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--png") == 0) pngDir = argv[i + 1];
+        else if (std::strcmp(argv[i], "--fps") == 0) exportFps = std::max(1, std::atoi(argv[i + 1]));
+    }
+    const bool exporting = !exportPath.empty();
+
+    // --startup-timing prints time to the first frame and until every asset
+    // is loaded, on stderr.
+    bool startupTiming = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--startup-timing") == 0) startupTiming = true;
+
+    sf::RenderWindow window;
+    if (!exporting) window.create(sf::VideoMode(width, height), "Serpent Rush");
+    FrameScheduler scheduler;
     bool musicOn = true;
     bool canContinue = false;
 
+    // --- Asset loading ---
+    // Files are read and decoded on worker threads while a loading screen is
+    // shown. The font is queued first so the loading text appears early.
+    // Everything comes from assets.pak next to the executable when it exists;
+    // loose files are resolved against the executable too, not the CWD.
+    const std::string exeDir = executableDir();
+    AssetArchive archive;
+    archive.open(exeDir + "assets.pak");
+    AssetManager assets(archive.isOpen() ? &archive : nullptr);
+    assets.loadBytes("font", exeDir + "consolas.ttf");
+    assets.loadSound("spawn", exeDir + "../resources/spawn.wav");
+    assets.loadSound("eat", exeDir + "../resources/eat.wav");
+    assets.loadImage("apple", exeDir + "../resources/apple.png");
+    assets.loadImage("snakeSkin", exeDir + "../resources/snake.png");
+    assets.loadBytes("music", exeDir + "../resources/background.ogg");
+    assets.loadBytes("menus", exeDir + "../resources/menus.txt");
+
     // --- Font ---
     sf::Font font;
-    if (!font.loadFromFile("consolas.ttf")) return -1;
+    bool fontLoaded = false;
+
+    // --- Loading screen ---
+    sf::RectangleShape progressFrame(sf::Vector2f(400, 24));
+    progressFrame.setOrigin(200, 12);
+    progressFrame.setPosition(width / 2.f, height / 2.f + 40);
+    progressFrame.setFillColor(sf::Color::Transparent);
+    progressFrame.setOutlineColor(sf::Color::Black);
+    progressFrame.setOutlineThickness(2);
+
+    sf::RectangleShape progressBar;
+    progressBar.setFillColor(sf::Color(0, 150, 0));
+    progressBar.setPosition(width / 2.f - 200, height / 2.f + 28);
+
+    sf::Text loadingText;
+    loadingText.setString("Loading...");
+    loadingText.setCharacterSize(32);
+    loadingText.setFillColor(sf::Color::Black);
+    loadingText.setPosition(width / 2.f, height / 2.f - 20);
+
+    if (exporting) {
+        // Headless: no loading screen, just wait for the workers.
+        while (!assets.done()) sf::sleep(sf::milliseconds(1));
+        MemoryView fontData = assets.bytes("font");
+        if (!fontData || !font.loadFromMemory(fontData.data, fontData.size)) return -1;
+    } else {
+        scheduler.setRate(window, 60);
+        bool firstFrameShown = false;
+        for (;;) {
+            sf::Event event;
+            while (window.pollEvent(event)) {
+                if (event.type == sf::Event::Closed)
+                    return 0;
+            }
+
+            if (!fontLoaded && assets.isReady("font")) {
+                MemoryView fontData = assets.bytes("font");
+                if (!fontData || !font.loadFromMemory(fontData.data, fontData.size)) return -1;
+                fontLoaded = true;
+                loadingText.setFont(font);
+                sf::FloatRect lt = loadingText.getLocalBounds();
+                loadingText.setOrigin(lt.left + lt.width / 2, lt.top + lt.height / 2);
+            }
+
+            window.clear(sf::Color(200, 200, 200));
+            progressBar.setSize(sf::Vector2f(400 * assets.progress(), 24));
+            window.draw(progressFrame);
+            window.draw(progressBar);
+            if (fontLoaded) window.draw(loadingText);
+            window.display();
 
-    // --- Music ---
-    sf::Music music;
-    if (music.openFromFile("../resources/background.ogg")) {
-        music.setLoop(true);
-        music.play();
+            if (startupTiming && !firstFrameShown) {
+                firstFrameShown = true;
+                std::cerr << "Startup: first frame after " << startupClock.getElapsedTime().asMilliseconds() << " ms\n";
+            }
+            if (assets.done() && fontLoaded) break;
+        }
+        if (startupTiming)
+            std::cerr << "Startup: assets ready after " << startupClock.getElapsedTime().asMilliseconds() << " ms\n";
     }
 
-    // --- Menu Buttons ---
-    sf::RectangleShape startBtn(sf::Vector2f(300, 60));
-    startBtn.setFillColor(sf::Color(0, 150, 0));
-    startBtn.setOrigin(150, 30);
-    startBtn.setPosition(width / 2.f, height / 2.f);
-
-    sf::Text startBtnText("Start Game", font, 32);
-    startBtnText.setFillColor(sf::Color::White);
-    sf::FloatRect sbt = startBtnText.getLocalBounds();
-    startBtnText.setOrigin(sbt.left + sbt.width / 2, sbt.top + sbt.height / 2);
-    startBtnText.setPosition(width / 2.f, height / 2.f);
-
-    sf::RectangleShape continueBtn(sf::Vector2f(300, 60));
-    continueBtn.setFillColor(sf::Color(200, 150, 0));
-    continueBtn.setOrigin(150, 30);
-    continueBtn.setPosition(width / 2.f, height / 2.f + 80);
-
-    sf::Text continueBtnText("Continue", font, 32);
-    continueBtnText.setFillColor(sf::Color::White);
-    sf::FloatRect cbt = continueBtnText.getLocalBounds();
-    continueBtnText.setOrigin(cbt.left + cbt.width / 2, cbt.top + cbt.height / 2);
-    continueBtnText.setPosition(width / 2.f, height / 2.f + 80);
-
-    sf::RectangleShape highBtn(sf::Vector2f(300, 60));
-    highBtn.setFillColor(sf::Color(0, 100, 200));
-    highBtn.setOrigin(150, 30);
-    highBtn.setPosition(width / 2.f, height / 2.f + 170);
-
-    sf::Text highBtnText("High Scores", font, 32);
-    highBtnText.setFillColor(sf::Color::White);
-    sf::FloatRect hbt = highBtnText.getLocalBounds();
-    highBtnText.setOrigin(hbt.left + hbt.width / 2, hbt.top + hbt.height / 2);
-    highBtnText.setPosition(width / 2.f, height / 2.f + 170);
-
-    sf::RectangleShape musicBtn(sf::Vector2f(200, 50));
-    musicBtn.setFillColor(sf::Color(100, 100, 100));
-    musicBtn.setOrigin(100, 25);
-    musicBtn.setPosition(width / 2.f, height - 80);
-
-    sf::Text musicBtnText("Music: ON", font, 28);
-    musicBtnText.setFillColor(sf::Color::White);
-    sf::FloatRect mbt = musicBtnText.getLocalBounds();
-    musicBtnText.setOrigin(mbt.left + mbt.width / 2, mbt.top + mbt.height / 2);
-    musicBtnText.setPosition(width / 2.f, height - 80);
-
-    // --- High Score Window ---
-    sf::Text highTitle("High Scores", font, 40);
-    highTitle.setFillColor(sf::Color::White);
-    sf::FloatRect ht = highTitle.getLocalBounds();
-    highTitle.setOrigin(ht.left + ht.width / 2, ht.top + ht.height / 2);
-    highTitle.setPosition(width / 2.f, 80);
-
-    sf::RectangleShape backBtn(sf::Vector2f(200, 50));
-    backBtn.setFillColor(sf::Color(150, 0, 0));
-    backBtn.setOrigin(100, 25);
-    backBtn.setPosition(width / 2.f, height - 100);
-
-    sf::Text backBtnText("Back", font, 28);
-    backBtnText.setFillColor(sf::Color::White);
-    sf::FloatRect bbt = backBtnText.getLocalBounds();
-    backBtnText.setOrigin(bbt.left + bbt.width / 2, bbt.top + bbt.height / 2);
-    backBtnText.setPosition(width / 2.f, height - 100);
-
-    // --- Menu Title ---
-    sf::Text menuTitle;
-    menuTitle.setFont(font);
-    menuTitle.setCharacterSize(48);
-    menuTitle.setFillColor(sf::Color::White);
-    menuTitle.setString("SERPENT RUSH");
+    // --- Audio: music and effects share one mixed stream ---
+    AudioMixer mixer;
+    MemoryView musicData = assets.bytes("music");
+    if (musicData) mixer.openMusic(musicData.data, musicData.size);
+
+    // --- Sound: food spawn and eating ---
+    const sf::SoundBuffer* spawnBuffer = assets.sound("spawn");
+    const sf::SoundBuffer* eatBuffer = assets.sound("eat");
+    int spawnSound = spawnBuffer ? mixer.addEffect(*spawnBuffer) : -1;
+    int eatSound = eatBuffer ? mixer.addEffect(*eatBuffer) : -1;
+    if (!exporting) mixer.play();
+
+    // --- Menus ---
+    // Buttons and titles are laid out in menus.txt (ui.hpp) and found by id.
+    UiLayout ui(font);
+    {
+        MemoryView menuData = assets.bytes("menus");
+        std::istringstream menuText(menuData ? std::string(menuData.data, menuData.size) : std::string());
+        std::string error;
+        if (!menuData || !ui.load(menuText, error)) {
+            std::cerr << "menus.txt: " << (menuData ? error : "cannot open") << "\n";
+            return -1;
+        }
+    }
+    UiScreen* menuScreen = ui.screen("menu");
+    UiScreen* highScoreScreen = ui.screen("highscores");
+    if (!menuScreen || !highScoreScreen) {
+        std::cerr << "menus.txt: needs screens 'menu' and 'highscores'\n";
+        return -1;
+    }
+    const int levelBtn = menuScreen->indexOf("level");
+    const int startBtn = menuScreen->indexOf("start");
+    const int continueBtn = menuScreen->indexOf("continue");
+    const int highBtn = menuScreen->indexOf("scores");
+    const int musicBtn = menuScreen->indexOf("music");
+    const int backBtn = highScoreScreen->indexOf("back");
+    if (std::min({levelBtn, startBtn, continueBtn, highBtn, musicBtn, backBtn}) < 0) {
+        std::cerr << "menus.txt: needs buttons level, start, continue, scores, music and back\n";
+        return -1;
+    }
+    menuScreen->setVisible(continueBtn, canContinue);
+
+    // --- Level selection ---
+    // Entry 0 is the built-in classic board, then the level files, then
+    // endless mode; switched from the menu without restarting.
+    std::vector<std::string> levelFiles = findLevelFiles(exeDir + "../resources/levels");
+    size_t levelIndex = 0;
+    std::string levelName = "Classic";
+    bool endless = false;
+    int endlessStage = 0;
+    std::uint32_t endlessSeed = static_cast<std::uint32_t>(time(0));
+
+    menuScreen->setLabel(levelBtn, "Level: " + levelName);
+
+    // --- Cached static screens ---
+    // Menu and high score screens are rendered once; afterwards only the
+    // widgets that changed are repainted. Hover highlights are drawn on top.
+    const sf::Color backgroundColor(200, 200, 200);
+    CachedLayer menuLayer;
+    menuLayer.create(width, height, backgroundColor);
+    CachedLayer highScoreLayer;
+    highScoreLayer.create(width, height, backgroundColor);
+
+    const UiScreen* hoveredScreen = nullptr;
+    int hoveredBtn = -1;
+    sf::RectangleShape hoverOverlay;
+    hoverOverlay.setFillColor(sf::Color(255, 255, 255, 60));
 
     // --- Pause/Game Over/Menu Texts ---
     sf::Text pauseText;
@@ -213,100 +291,375 @@ int main() {
     int score = 0;
     int highScore = 0;
     std::stack<int> scoreHistory;
-    sf::Text scoreText;
-    scoreText.setFont(font);
-    scoreText.setCharacterSize(28);
-    scoreText.setFillColor(sf::Color::Black);
 
     GameState state = MENU;
 
-    // --- Sound: food spawn ---
-    sf::SoundBuffer spawnBuffer;
-    sf::Sound spawnSound;
-    if (spawnBuffer.loadFromFile("../resources/spawn.wav")) {
-        spawnSound.setBuffer(spawnBuffer);
+    // --- Sprite atlas: apple, snake skin and wall tiles in one texture ---
+    // Decoded images are uploaded here, on the thread that owns the context.
+    TextureAtlas atlas;
+    buildGameAtlas(atlas, assets.image("apple"), assets.image("snakeSkin"));
+
+    Playfield playfield(atlas, font);
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--shader-board") == 0 && !playfield.useShaderBoard())
+            std::cerr << "Shaders unavailable, drawing the board with sprites\n";
+        else if (std::strcmp(argv[i], "--dirty-board") == 0)
+            playfield.useDirtyBoard(width, height, backgroundColor);
+        else if (std::strcmp(argv[i], "--smooth-snake") == 0)
+            playfield.useSmoothSnake();
     }
+    playfield.rebuild();
+    // The smooth snake draws a frame per refresh; vsync paces the loop.
+    if (playfield.isSmooth() && !exporting) window.setVerticalSyncEnabled(true);
 
-    // --- Sound: eating ---
-    sf::SoundBuffer eatBuffer;
-    sf::Sound eatSound;
-    if (eatBuffer.loadFromFile("../resources/eat.wav")) {
-        eatSound.setBuffer(eatBuffer);
-    }
+    auto startEndlessStage = [&](int stage) {
+        endlessStage = stage;
+        applyLevel(generateLevel(endlessStageSettings(endlessSeed, stage)));
+        playfield.rebuild();
+    };
+
+    Snake snake;
+    sf::Vector2i food = generateFoodPosition(snake);
 
-    // --- Apple image ---
-    sf::Texture appleTexture;
-    bool appleImgLoaded = appleTexture.loadFromFile("../resources/apple.png");
-    sf::Sprite appleSprite;
-    if (appleImgLoaded) {
-        appleSprite.setTexture(appleTexture);
-        appleSprite.setScale(
-            (blockSize - 2) / static_cast<float>(appleTexture.getSize().x),
-            (blockSize - 2) / static_cast<float>(appleTexture.getSize().y)
-        );
+    // --- Replays ---
+    // Every game reseeds rand() for its food, so it can be replayed from
+    // its moves alone (replay.hpp). --record FILE saves each finished game.
+    Replay replay;
+    bool levelSwapped = false;  // hot reload changed the board mid-game; not saved
+    std::string recordPath;
+    for (int i = 1; i + 1 < argc; ++i)
+        if (std::strcmp(argv[i], "--record") == 0) recordPath = argv[i + 1];
+
+    auto beginGame = [&](std::uint32_t foodSeed) {
+        if (endless) startEndlessStage(0);
+        srand(foodSeed);
+        playfield.getEffects().clear();
+        snake = Snake();
+        food = generateFoodPosition(snake);
+        score = 0;
+        replay = Replay();
+        replay.level = endless ? "Endless" : levelIndex == 0 ? "Classic" : AssetArchive::baseName(levelFiles[levelIndex - 1]);
+        replay.endlessSeed = endlessSeed;
+        replay.foodSeed = foodSeed;
+        levelSwapped = false;
+    };
+
+    // --- Particles ---
+    // Sparks from eaten food and from a dead snake's body, drawn by the
+    // playfield. They use their own random numbers, not rand().
+    auto cellCenter = [](int x, int y) {
+        return sf::Vector2f(x * blockSize + (blockSize - 2) / 2.f, y * blockSize + (blockSize - 2) / 2.f);
+    };
+
+    // One tick of a running game, shared by the window loop and the exporter.
+    auto stepGame = [&]() {
+        replay.record(snake.dir);
+        const sf::Vector2i eaten = food;
+        TickResult result = tickGame(snake, food, score);
+        ParticlePool& effects = playfield.getEffects();
+        if (result == ATE) {
+            effects.burst(cellCenter(eaten.x, eaten.y), 24, sf::Color(220, 30, 30), 160, 0.5f);
+            effects.burst(cellCenter(eaten.x, eaten.y), 12, sf::Color(255, 210, 40), 220, 0.4f);
+        } else if (result == DIED) {
+            for (const SnakeSegment& part : snake.body)
+                effects.burst(cellCenter(part.x, part.y), 8, sf::Color(0, 150, 0), 90, 0.9f);
+            effects.burst(cellCenter(snake.body.front().x, snake.body.front().y), 40, sf::Color(255, 140, 0), 240, 1.2f);
+        }
+        if (result == ATE && endless && score >= (endlessStage + 1) * endlessStagePoints) {
+            // Next stage: new board, same score.
+            startEndlessStage(endlessStage + 1);
+            snake = Snake();
+            food = generateFoodPosition(snake);
+        }
+        return result;
+    };
+
+    if (exporting) {
+        Replay recorded;
+        std::string error;
+        if (!recorded.load(exportPath, error)) {
+            std::cerr << exportPath << ": " << error << "\n";
+            return 1;
+        }
+        if (recorded.level == "Endless") {
+            endless = true;
+            endlessSeed = recorded.endlessSeed;
+        } else if (recorded.level != "Classic") {
+            auto file = std::find_if(levelFiles.begin(), levelFiles.end(), [&](const std::string& path) {
+                return AssetArchive::baseName(path) == recorded.level;
+            });
+            Level level;
+            if (file == levelFiles.end() || !loadLevelFile(*file, level, error)) {
+                std::cerr << recorded.level << ": " << (file == levelFiles.end() ? "level not found" : error) << "\n";
+                return 1;
+            }
+            levelIndex = file - levelFiles.begin() + 1;
+            applyLevel(level);
+        }
+        playfield.rebuild();
+        beginGame(recorded.foodSeed);
+
+        sf::RenderTexture frame;
+        if (!frame.create(width, height)) return 1;
+        FrameCapture capture(width, height, pngDir.empty() ? FrameCapture::RAW_RGBA : FrameCapture::PNG_FILES, pngDir);
+        // Sparks move every frame, so while any are flying a held tick is
+        // drawn frame by frame. They advance by the time each image stands
+        // for, as in the game.
+        auto render = [&](unsigned int repeat, float tickProgress) {
+            ParticlePool& effects = playfield.getEffects();
+            while (repeat > 0) {
+                const unsigned int frames = effects.empty() ? repeat : 1;
+                if (!playfield.coversTarget()) frame.clear(backgroundColor);
+                playfield.draw(frame, snake, food, score, score, tickProgress);
+                frame.display();
+                capture.capture(frame, frames);
+                effects.update(static_cast<float>(frames) / exportFps);
+                repeat -= frames;
+            }
+        };
+
+        // Each tick is on screen for 1/speed seconds, as in the game; a tick
+        // shorter than a video frame is simulated but not drawn. The smooth
+        // snake moves within a tick, so it gets every frame drawn.
+        sf::Clock exportClock;
+        double gameTime = 0;
+        unsigned long long framesDue = 0, framesDone = 0;
+        for (size_t tick = 0; tick < recorded.moves.size(); ++tick) {
+            int speed = levelRules.baseSpeed + score / levelRules.speedStep;
+            snake.dir = recorded.move(tick);
+            if (stepGame() == DIED) break;
+            const double tickStart = gameTime;
+            gameTime += 1.0 / speed;
+            framesDue = static_cast<unsigned long long>(gameTime * exportFps);
+            if (playfield.isSmooth()) {
+                for (; framesDone < framesDue; ++framesDone)
+                    render(1, static_cast<float>((static_cast<double>(framesDone) / exportFps - tickStart) * speed));
+            } else {
+                if (framesDue > framesDone) render(static_cast<unsigned int>(framesDue - framesDone), 1.f);
+                framesDone = framesDue;
+            }
+        }
+        render(exportFps, 1.f);  // hold the final board for a second
+        gameTime += 1.0;
+        capture.finish();
+
+        float seconds = exportClock.getElapsedTime().asSeconds();
+        std::cerr << "Exported " << capture.getFramesWritten() << " frames (" << gameTime << " s of play) in " << seconds
+                  << " s, " << gameTime / std::max(seconds, 0.001f) << "x real time"
+                  << (capture.usesBuffers() ? "" : ", without pixel buffers") << "\n";
+        return capture.ok() ? 0 : 1;
     }
 
- 
+    // --- Hot reload (development) ---
+    // With --hot-reload, a watcher thread decodes changed files from
+    // resources/ and resources/levels/ into double-buffered slots; the main
+    // loop swaps them in between ticks. Music is not reloaded. Levels match
+    // by stem, so saving crossroads.txt reloads the level that was loaded
+    // from crossroads.lvl, from the edited source.
+    bool hotReload = false;
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--hot-reload") == 0) hotReload = true;
+
+    struct ReloadedLevel {
+        std::string stem;
+        Level level;
+    };
+    AssetSlot<sf::Image> appleSlot, skinSlot;
+    AssetSlot<sf::SoundBuffer> spawnSlot, eatSlot;
+    AssetSlot<ReloadedLevel> levelSlot;
+    std::unique_ptr<FileWatcher> watcher;
+    if (hotReload) {
+        const std::string levelsDir = exeDir + "../resources/levels";
+        std::vector<std::string> watchDirs = { exeDir + "../resources", levelsDir };
+        // The callback runs on the watcher thread after this block ends, so
+        // levelsDir is captured by value.
+        watcher.reset(new FileWatcher(watchDirs, [&, levelsDir](const std::string& path) {
+            std::string name = AssetArchive::baseName(path);
+            std::unique_ptr<sf::Image> image(new sf::Image());
+            std::unique_ptr<sf::SoundBuffer> sound(new sf::SoundBuffer());
+            if (name == "apple.png" && image->loadFromFile(path)) appleSlot.publish(std::move(image));
+            else if (name == "snake.png" && image->loadFromFile(path)) skinSlot.publish(std::move(image));
+            else if (name == "spawn.wav" && sound->loadFromFile(path)) spawnSlot.publish(std::move(sound));
+            else if (name == "eat.wav" && sound->loadFromFile(path)) eatSlot.publish(std::move(sound));
+            else if (path.compare(0, levelsDir.size(), levelsDir) == 0) {
+                std::filesystem::path file(path);
+                if (file.extension() != ".txt" && file.extension() != ".lvl") return;
+                std::unique_ptr<ReloadedLevel> next(new ReloadedLevel());
+                next->stem = file.stem().string();
+                std::string error;
+                if (loadLevelFile(path, next->level, error)) levelSlot.publish(std::move(next));
+                else std::cerr << path << ": " << error << "\n";
+            }
+        }));
+        std::cout << "Hot reload: watching " << exeDir << "../resources\n";
+    }
 
-    Snake snake;
-    sf::Vector2i food = generateFoodPosition(snake);
+    // Runs between ticks: swaps in whatever the watcher finished loading.
+    auto applyReloads = [&]() {
+        bool apple = appleSlot.swap();
+        bool skin = skinSlot.swap();
+        if (apple || skin) {
+            buildGameAtlas(atlas, appleSlot.get() ? appleSlot.get() : assets.image("apple"),
+                           skinSlot.get() ? skinSlot.get() : assets.image("snakeSkin"));
+            playfield.rebuild();
+        }
+        if (spawnSlot.swap()) {
+            if (spawnSound < 0) spawnSound = mixer.addEffect(*spawnSlot.get());
+            else mixer.replaceEffect(spawnSound, *spawnSlot.get());
+        }
+        if (eatSlot.swap()) {
+            if (eatSound < 0) eatSound = mixer.addEffect(*eatSlot.get());
+            else mixer.replaceEffect(eatSound, *eatSlot.get());
+        }
+        if (levelSlot.swap() && !endless && levelIndex > 0 &&
+            std::filesystem::path(levelFiles[levelIndex - 1]).stem().string() == levelSlot.get()->stem) {
+            // The snake keeps its position if the new board still has room
+            // for it, and starts over at the spawn point if not. Misplaced
+            // food moves.
+            applyLevel(levelSlot.get()->level);
+            playfield.rebuild();
+            auto blocked = [](int x, int y) { return x < 0 || y < 0 || x >= gridCols || y >= gridRows || wallGrid[y][x]; };
+            bool snakeFits = true;
+            for (const SnakeSegment& part : snake.body)
+                if (blocked(part.x, part.y)) snakeFits = false;
+            if (!snakeFits) snake = Snake();
+            bool foodOnSnake = false;
+            for (const SnakeSegment& part : snake.body)
+                if (part.x == food.x && part.y == food.y) foodOnSnake = true;
+            if (blocked(food.x, food.y) || foodOnSnake)
+                food = generateFoodPosition(snake);
+            // The replay would play the rest of the game on the old board.
+            if (state == PLAYING || state == PAUSED) levelSwapped = true;
+        }
+    };
+
+    // --- Online leaderboard ---
+    // With --leaderboard host:port, every finished game is submitted to
+    // serpent_leaderboard under --name, and the high score screen shows the
+    // global top five instead of the local history. Requests run on the
+    // uploader's thread; the loop only queues them and picks up answers.
+    std::unique_ptr<ScoreUploader> leaderboard;
+    std::string playerName = "player";
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--leaderboard") == 0) {
+            std::string address = argv[i + 1];
+            size_t colon = address.rfind(':');
+            int port = colon == std::string::npos ? 8090 : std::atoi(address.c_str() + colon + 1);
+            leaderboard.reset(new ScoreUploader(address.substr(0, colon), static_cast<unsigned short>(port), exeDir + "scores.spool"));
+        } else if (std::strcmp(argv[i], "--name") == 0) {
+            playerName = argv[i + 1];
+        }
+    }
+    if (!isValidPlayerName(playerName)) {
+        std::cerr << "--name takes up to 16 letters, digits, '_' or '-'; using \"player\"\n";
+        playerName = "player";
+    }
+    size_t worldRank = 0;  // of the player's best game, 0 until the service answers
+    std::vector<ScoreEntry> worldTop;
 
-    sf::RectangleShape block(sf::Vector2f(blockSize - 2, blockSize - 2));
-    block.setFillColor(sf::Color(0, 100, 0)); // Dark green
+    // With the smooth snake, ticks run off a clock instead of the frame
+    // rate; tickProgress is how far the current one is through.
+    sf::Clock tickClock;
+    float tickTime = 0, tickProgress = 1;
+    bool ticking = false;
 
-    sf::RectangleShape foodBlock(sf::Vector2f(blockSize - 2, blockSize - 2));
-    foodBlock.setFillColor(sf::Color::Red);
+    // Sparks move with the frame time, as long as a game is on screen.
+    sf::Clock effectsClock;
 
-    sf::RectangleShape wallBlock(sf::Vector2f(blockSize - 2, blockSize - 2));
-    wallBlock.setFillColor(sf::Color(100, 100, 100));
+    // --cpu-report prints CPU use per screen (scheduler.hpp), to check that
+    // idle screens really sleep.
+    std::unique_ptr<CpuReport> cpuReport;
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], "--cpu-report") == 0) cpuReport.reset(new CpuReport());
+    const char* const screenNames[] = { "menu", "playing", "paused", "game over", "high scores" };
 
     while (window.isOpen()) {
         sf::Event event;
-        while (window.pollEvent(event)) {
+        bool idle = state != PLAYING;
+        // Sparks still flying need full-rate frames. Hot reload and a
+        // leaderboard answer still on its way only need idle screens to wake
+        // now and then, so swaps and ranks show up without input.
+        bool animating = state == GAMEOVER && !playfield.getEffects().empty();
+        bool polling = hotReload || (leaderboard && leaderboard->isAwaiting());
+        for (bool pending = scheduler.firstEvent(window, event, idle, animating, polling); pending; pending = window.pollEvent(event)) {
             if (event.type == sf::Event::Closed)
                 window.close();
 
             sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
 
+            if (event.type == sf::Event::MouseMoved) {
+                hoveredScreen = state == MENU || state == PAUSED ? menuScreen : state == HIGHSCORES ? highScoreScreen : nullptr;
+                hoveredBtn = hoveredScreen ? hoveredScreen->hitTest(mousePos) : -1;
+            }
+
             if (state == MENU || state == PAUSED) {
                 if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                    if (isMouseOver(startBtn, mousePos)) {
-                        snake = Snake();
-                        food = generateFoodPosition(snake);
-                        score = 0;
+                    int clicked = menuScreen->hitTest(mousePos);
+                    if (clicked == startBtn) {
+                        if (endless) ++endlessSeed;
+                        beginGame(static_cast<std::uint32_t>(rand()));
                         state = PLAYING;
                         canContinue = true;
-                        spawnSound.play();
-                    } else if (canContinue && isMouseOver(continueBtn, mousePos)) {
+                        menuScreen->setVisible(continueBtn, true);
+                        mixer.playEffect(spawnSound);
+                    } else if (clicked == continueBtn) {
                         state = PLAYING;
-                    } else if (isMouseOver(highBtn, mousePos)) {
+                    } else if (clicked == highBtn) {
                         state = HIGHSCORES;
-                    } else if (isMouseOver(musicBtn, mousePos)) {
-                        musicOn = !musicOn;
-                        if (musicOn) {
-                            music.play();
-                            musicBtnText.setString("Music: ON");
-                        } else {
-                            music.pause();
-                            musicBtnText.setString("Music: OFF");
+                        if (leaderboard) leaderboard->requestTop(5);
+                    } else if (clicked == levelBtn) {
+                        // Cycle to the next level that loads; broken files are skipped.
+                        endless = false;
+                        for (size_t tries = 0; tries <= levelFiles.size(); ++tries) {
+                            levelIndex = (levelIndex + 1) % (levelFiles.size() + 2);
+                            if (levelIndex == 0) {
+                                setupWalls();
+                                levelName = "Classic";
+                                break;
+                            }
+                            if (levelIndex == levelFiles.size() + 1) {
+                                endless = true;
+                                startEndlessStage(0);
+                                levelName = "Endless";
+                                break;
+                            }
+                            Level level;
+                            std::string error;
+                            if (loadLevelFile(levelFiles[levelIndex - 1], level, error)) {
+                                applyLevel(level);
+                                levelName = level.name;
+                                break;
+                            }
+                            std::cerr << levelFiles[levelIndex - 1] << ": " << error << "\n";
                         }
-                        sf::FloatRect mbt2 = musicBtnText.getLocalBounds();
-                        musicBtnText.setOrigin(mbt2.left + mbt2.width / 2, mbt2.top + mbt2.height / 2);
+                        if (!endless) playfield.rebuild();
+                        snake = Snake();
+                        food = generateFoodPosition(snake);
+                        canContinue = false;
+                        menuScreen->setVisible(continueBtn, false);
+                        menuScreen->setLabel(levelBtn, "Level: " + levelName);
+                    } else if (clicked == musicBtn) {
+                        musicOn = !musicOn;
+                        mixer.setMusicPaused(!musicOn);
+                        menuScreen->setLabel(musicBtn, musicOn ? "Music: ON" : "Music: OFF");
                     }
                 }
             }
             else if (state == HIGHSCORES) {
                 if (event.type == sf::Event::MouseButtonPressed && event.mouseButton.button == sf::Mouse::Left) {
-                    if (isMouseOver(backBtn, mousePos)) {
+                    if (highScoreScreen->hitTest(mousePos) == backBtn) {
                         state = MENU;
                     }
                 }
             }
             else if (state == PLAYING && event.type == sf::Event::KeyPressed) {
-                if (event.key.code == sf::Keyboard::Up && snake.dir != Down) snake.dir = Up;
-                else if (event.key.code == sf::Keyboard::Down && snake.dir != Up) snake.dir = Down;
-                else if (event.key.code == sf::Keyboard::Left && snake.dir != Right) snake.dir = Left;
-                else if (event.key.code == sf::Keyboard::Right && snake.dir != Left) snake.dir = Right;
+                // Checked against the last move, not the last key: two presses
+                // within one tick must not turn the snake back on itself.
+                Direction heading = snake.body.size() > 1 ? directionTo(snake.body[1], snake.body[0]) : snake.dir;
+                if (event.key.code == sf::Keyboard::Up && heading != Down) snake.dir = Up;
+                else if (event.key.code == sf::Keyboard::Down && heading != Up) snake.dir = Down;
+                else if (event.key.code == sf::Keyboard::Left && heading != Right) snake.dir = Left;
+                else if (event.key.code == sf::Keyboard::Right && heading != Left) snake.dir = Right;
                 else if (event.key.code == sf::Keyboard::Space) {
                     state = PAUSED;
                 }
@@ -316,129 +669,96 @@ int main() {
             }
         }
 
+        applyReloads();
+
+        if (leaderboard) {
+            worldRank = leaderboard->latestRank();
+            if (leaderboard->takeTop(worldTop)) highScoreLayer.invalidate();
+        }
+
         if (state == PLAYING) {
-            int newSpeed = baseSpeed + score / 5;
-            window.setFramerateLimit(newSpeed);
-
-            SnakeSegment nextHead = snake.body.front();
-            switch (snake.dir) {
-                case Up: nextHead.y--; break;
-                case Down: nextHead.y++; break;
-                case Left: nextHead.x--; break;
-                case Right: nextHead.x++; break;
-            }
-            if (nextHead.x < 0 || nextHead.y < 0 || nextHead.x >= width / blockSize || nextHead.y >= height / blockSize || wallGrid[nextHead.y][nextHead.x]) {
-                if (score > highScore) highScore = score;
-                scoreHistory.push(score);
-                state = GAMEOVER;
+            int newSpeed = levelRules.baseSpeed + score / levelRules.speedStep;
+            int ticks = 1;
+            if (playfield.isSmooth()) {
+                // Frames at the refresh rate, ticks as they fall due. After a
+                // stall, time beyond two ticks is dropped rather than raced.
+                scheduler.setRate(window, 0);
+                float elapsed = tickClock.restart().asSeconds();
+                if (ticking) tickTime = std::min(tickTime + elapsed, 2.f / newSpeed);
+                ticks = static_cast<int>(tickTime * newSpeed);
+                tickTime -= static_cast<float>(ticks) / newSpeed;
+                tickProgress = tickTime * newSpeed;
             } else {
-                snake.move();
-                if (snake.body.front().x == food.x && snake.body.front().y == food.y) {
-                    snake.grow();
-                    food = generateFoodPosition(snake);
-                    score++;
-                    eatSound.play();
-                    spawnSound.play();
-                }
-                if (snake.checkCollision()) {
+                scheduler.setRate(window, newSpeed);
+            }
+
+            for (int i = 0; i < ticks && state == PLAYING; ++i) {
+                TickResult result = stepGame();
+                if (result == ATE) {
+                    mixer.playEffect(eatSound, PRIORITY_HIGH);
+                    mixer.playEffect(spawnSound, PRIORITY_LOW);
+                } else if (result == DIED) {
+                    if (!recordPath.empty() && levelSwapped)
+                        std::cerr << "Not saving the replay: the level was reloaded during the game\n";
+                    else if (!recordPath.empty() && !replay.save(recordPath))
+                        std::cerr << "Could not save the replay to " << recordPath << "\n";
                     if (score > highScore) highScore = score;
                     scoreHistory.push(score);
+                    if (leaderboard) leaderboard->submit(playerName, score);
+                    highScoreLayer.invalidate();
                     state = GAMEOVER;
                 }
             }
         }
+        ticking = state == PLAYING;
 
-        window.clear(sf::Color(200, 200, 200)); // Light gray background
-
-        if (state == MENU || state == PAUSED) {
-            // Centered title
-            sf::FloatRect titleRect = menuTitle.getLocalBounds();
-            menuTitle.setOrigin(titleRect.left + titleRect.width / 2.0f, titleRect.top + titleRect.height / 2.0f);
-            menuTitle.setPosition(width / 2.0f, height / 2.0f - 120);
-            window.draw(menuTitle);
-
-            window.draw(startBtn);
-            window.draw(startBtnText);
-
-            if (canContinue) {
-                window.draw(continueBtn);
-                window.draw(continueBtnText);
-            }
+        float frameTime = std::min(effectsClock.restart().asSeconds(), 0.1f);
+        if (state == PLAYING || state == GAMEOVER) playfield.getEffects().update(frameTime);
 
-            window.draw(highBtn);
-            window.draw(highBtnText);
+        // The dirty board's blit covers the whole window.
+        bool boardCovers = playfield.coversTarget() && (state == PLAYING || state == GAMEOVER);
+        if (!boardCovers) window.clear(backgroundColor); // Light gray background
 
-            window.draw(musicBtn);
-            window.draw(musicBtnText);
+        if (state == MENU || state == PAUSED) {
+            menuLayer.update([&](sf::RenderTarget& target) { menuScreen->paintAll(target); });
+            if (menuScreen->isDirty())
+                menuLayer.patch([&](sf::RenderTarget& target) { menuScreen->paintDirty(target, backgroundColor); });
+            window.draw(menuLayer);
         }
         else if (state == HIGHSCORES) {
-            window.draw(highTitle);
-
-            // Show last 5 scores
-            sf::Text histText;
-            histText.setFont(font);
-            histText.setCharacterSize(32);
-            histText.setFillColor(sf::Color::Black);
-            histText.setStyle(sf::Text::Bold);
-            histText.setPosition(width / 2.f - 80, 160);
-
-            std::stack<int> temp = scoreHistory;
-            std::string histStr = "";
-            int count = 0;
-            while (!temp.empty() && count < 5) {
-                histStr += std::to_string(temp.top()) + "\n";
-                temp.pop();
-                count++;
-            }
-            if (histStr.empty()) histStr = "No scores yet!";
-            histText.setString(histStr);
-            window.draw(histText);
-
-            window.draw(backBtn);
-            window.draw(backBtnText);
+            highScoreLayer.update([&](sf::RenderTarget& target) {
+                highScoreScreen->paintAll(target);
+
+                // Show last 5 scores
+                sf::Text histText;
+                histText.setFont(font);
+                histText.setCharacterSize(32);
+                histText.setFillColor(sf::Color::Black);
+                histText.setStyle(sf::Text::Bold);
+                histText.setPosition(width / 2.f - 80, 160);
+
+                std::stack<int> temp = scoreHistory;
+                std::string histStr = "";
+                int count = 0;
+                if (leaderboard && !worldTop.empty()) {
+                    // Global top five from the leaderboard service
+                    histText.setPosition(width / 2.f - 160, 160);
+                    for (size_t i = 0; i < worldTop.size(); ++i)
+                        histStr += std::to_string(i + 1) + ". " + worldTop[i].name + "  " + std::to_string(worldTop[i].score) + "\n";
+                }
+                while (histStr.empty() && !temp.empty() && count < 5) {
+                    histStr += std::to_string(temp.top()) + "\n";
+                    temp.pop();
+                    count++;
+                }
+                if (histStr.empty()) histStr = "No scores yet!";
+                histText.setString(histStr);
+                target.draw(histText);
+            });
+            window.draw(highScoreLayer);
         }
         else if (state == PLAYING || state == GAMEOVER) {
-            // Draw walls
-            for (int y = 0; y < height / blockSize; ++y) {
-                for (int x = 0; x < width / blockSize; ++x) {
-                    if (wallGrid[y][x]) {
-                        wallBlock.setPosition(x * blockSize, y * blockSize);
-                        window.draw(wallBlock);
-                    }
-                }
-            }
-            // Draw snake
-            for (const auto& segment : snake.body) {
-    block.setPosition(segment.x * blockSize, segment.y * blockSize);
-    window.draw(block);
-}
-            // Draw food
-            if (appleImgLoaded) {
-                appleSprite.setPosition(food.x * blockSize, food.y * blockSize);
-                window.draw(appleSprite);
-            } else {
-                foodBlock.setPosition(food.x * blockSize, food.y * blockSize);
-                window.draw(foodBlock);
-            }
-
-            // --- Centered score and high score with boundary ---
-            std::string scoreStr = "Score: " + std::to_string(score) + "   High Score: " + std::to_string(highScore);
-            scoreText.setString(scoreStr);
-
-            sf::FloatRect textRect = scoreText.getLocalBounds();
-            scoreText.setOrigin(textRect.left + textRect.width / 2.0f, textRect.top + textRect.height / 2.0f);
-            scoreText.setPosition(width / 2.0f, 20);
-
-            sf::RectangleShape scoreBox;
-            scoreBox.setSize(sf::Vector2f(textRect.width + 40, textRect.height + 20));
-            scoreBox.setFillColor(sf::Color(255, 255, 255, 180));
-            scoreBox.setOutlineColor(sf::Color::Black);
-            scoreBox.setOutlineThickness(2);
-            scoreBox.setOrigin(scoreBox.getSize().x / 2.0f, scoreBox.getSize().y / 2.0f);
-            scoreBox.setPosition(width / 2.0f, 20 + textRect.height / 2.0f);
-
-            window.draw(scoreBox);
-            window.draw(scoreText);
+            playfield.draw(window, snake, food, score, highScore, state == PLAYING ? tickProgress : 1.f);
         }
 
         if (state == GAMEOVER) {
@@ -462,10 +782,20 @@ int main() {
                 temp.pop();
                 count++;
             }
+            if (worldRank > 0) histStr += "World rank: #" + std::to_string(worldRank) + "\n";
             histText.setString(histStr);
             window.draw(histText);
         }
 
+        const UiScreen* shownScreen = state == MENU || state == PAUSED ? menuScreen : state == HIGHSCORES ? highScoreScreen : nullptr;
+        if (hoveredBtn >= 0 && hoveredScreen == shownScreen && shownScreen && shownScreen->widget(hoveredBtn).visible) {
+            sf::FloatRect box = shownScreen->widget(hoveredBtn).box();
+            hoverOverlay.setSize(sf::Vector2f(box.width, box.height));
+            hoverOverlay.setPosition(box.left, box.top);
+            window.draw(hoverOverlay);
+        }
+
+        if (cpuReport) cpuReport->frame(screenNames[state]);
         window.display();
     }
 
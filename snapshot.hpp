@@ -0,0 +1,363 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "arena.hpp"
+
+// --- Bit packing ---
+// Values are written least significant bit first into a byte buffer, which
+// is then appended to an sf::Packet as-is.
+class BitWriter {
+public:
+    void write(std::uint32_t value, int bits) {
+        for (int i = 0; i < bits; ++i) {
+            if (bitCount % 8 == 0) bytes.push_back(0);
+            if ((value >> i) & 1u) bytes.back() |= static_cast<std::uint8_t>(1u << (bitCount % 8));
+            ++bitCount;
+        }
+    }
+
+    // 7 bits at a time plus a continuation bit; small numbers stay small.
+    void writeVar(std::uint32_t value) {
+        do {
+            std::uint32_t chunk = value & 0x7Fu;
+            value >>= 7;
+            write(chunk | (value ? 0x80u : 0u), 8);
+        } while (value);
+    }
+
+    void clear() {
+        bytes.clear();
+        bitCount = 0;
+    }
+
+    const std::uint8_t* data() const { return bytes.data(); }
+    std::size_t size() const { return bytes.size(); }
+    std::size_t bits() const { return bitCount; }
+
+private:
+    std::vector<std::uint8_t> bytes;
+    std::size_t bitCount = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const void* data, std::size_t size) : bytes(static_cast<const std::uint8_t*>(data)), size(size) {}
+
+    // Reading past the end returns zeros and clears ok().
+    std::uint32_t read(int bits) {
+        std::uint32_t value = 0;
+        for (int i = 0; i < bits; ++i) {
+            if (bitPos >= size * 8) {
+                valid = false;
+                return 0;
+            }
+            if ((bytes[bitPos / 8] >> (bitPos % 8)) & 1u) value |= 1u << i;
+            ++bitPos;
+        }
+        return value;
+    }
+
+    std::uint32_t readVar() {
+        std::uint32_t value = 0;
+        for (int shift = 0; shift < 35 && valid; shift += 7) {
+            std::uint32_t chunk = read(8);
+            value |= (chunk & 0x7Fu) << shift;
+            if (!(chunk & 0x80u)) return value;
+        }
+        valid = false;
+        return 0;
+    }
+
+    bool ok() const { return valid; }
+
+private:
+    const std::uint8_t* bytes;
+    std::size_t size;
+    std::size_t bitPos = 0;
+    bool valid = true;
+};
+
+// Bits needed for values 0..maxValue.
+inline int bitsFor(std::uint32_t maxValue) {
+    int bits = 1;
+    while (bits < 32 && (maxValue >> bits) != 0) ++bits;
+    return bits;
+}
+
+// Direction of the step from a to b; the cells must be neighbours.
+inline Direction stepDirection(const SnakeSegment& a, const SnakeSegment& b) {
+    if (b.x > a.x) return Right;
+    if (b.x < a.x) return Left;
+    return b.y > a.y ? Down : Up;
+}
+
+// --- Client-side arena state ---
+// Bodies are deques: a delta pushes a head and pops a tail every tick.
+struct SnapshotPlayer {
+    std::uint16_t id = 0;
+    bool alive = false;
+    std::uint32_t score = 0;
+    Direction dir = Right;
+    std::deque<SnakeSegment> body;
+};
+
+struct ArenaSnapshot {
+    std::uint32_t tick = 0;
+    std::uint32_t ackSeq = 0;  // newest input of the receiving client applied
+    bool valid = false;        // false until the first keyframe
+    std::vector<sf::Vector2i> foods;
+    std::vector<SnapshotPlayer> players;
+};
+
+// --- Snapshot encoding ---
+// A snake only ever gains a head next to the old one and maybe loses its
+// tail, so the state is sent two ways:
+//
+//   keyframe  every player in full; a body is its head plus 2 bits per
+//             segment (the step to the next one)
+//   delta     against the previous tick, per known player a 2-bit op:
+//               0 moved: 2-bit direction, 1 grow bit (grow = +1 score)
+//               1 unchanged (still dead)
+//               2 died, then the final score (it may have eaten first)
+//               3 then 1 bit: 0 left the arena, 1 respawned + full player
+//             then new players in full, then food: 1 kept-bit per old
+//             apple and the new ones appended
+//
+// A delta is only valid on top of the previous tick, so a client that
+// misses one asks for a keyframe; keyframes also go out every
+// keyframeInterval ticks.
+class SnapshotEncoder {
+public:
+    static constexpr std::uint32_t keyframeInterval = 40;  // 2 s at 20 Hz
+
+    explicit SnapshotEncoder(const Arena& arena)
+        : arena(arena), xBits(bitsFor(arena.getCols() - 1)), yBits(bitsFor(arena.getRows() - 1)) {}
+
+    // Call once after each arena tick. The keyframe is only built when
+    // asked for (or due); the delta every time.
+    void encode(bool keyframeWanted) {
+        keyframeBuilt = keyframeWanted || arena.getTick() % keyframeInterval == 0;
+        writeDelta();
+        if (keyframeBuilt) writeKeyframe();
+        remember();
+    }
+
+    bool keyframeDue() const { return arena.getTick() % keyframeInterval == 0; }
+    bool hasKeyframe() const { return keyframeBuilt; }
+    const BitWriter& keyframe() const { return keyframeBits; }
+    const BitWriter& delta() const { return deltaBits; }
+
+private:
+    struct Tracked {
+        std::uint16_t id;
+        std::uint32_t joinSerial;
+        bool alive;
+        SnakeSegment head;
+        std::size_t length;
+    };
+
+    void writePlayer(BitWriter& out, const ArenaPlayer& p) {
+        out.write(p.alive, 1);
+        out.writeVar(static_cast<std::uint32_t>(p.score));
+        if (!p.alive) return;
+        const std::deque<SnakeSegment>& body = p.body;
+        out.write(p.dir, 2);
+        out.writeVar(static_cast<std::uint32_t>(body.size()));
+        out.write(body[0].x, xBits);
+        out.write(body[0].y, yBits);
+        for (std::size_t i = 1; i < body.size(); ++i)
+            out.write(stepDirection(body[i - 1], body[i]), 2);
+    }
+
+    void writeKeyframe() {
+        keyframeBits.clear();
+        keyframeBits.writeVar(static_cast<std::uint32_t>(arena.foods.size()));
+        for (const sf::Vector2i& f : arena.foods) {
+            keyframeBits.write(f.x, xBits);
+            keyframeBits.write(f.y, yBits);
+        }
+        keyframeBits.writeVar(static_cast<std::uint32_t>(arena.players.size()));
+        for (const ArenaPlayer& p : arena.players) {
+            keyframeBits.write(p.id, 16);
+            writePlayer(keyframeBits, p);
+        }
+    }
+
+    void writeDelta() {
+        deltaBits.clear();
+        // Arena keeps players in join order and only erases, so walking
+        // both lists in step pairs them up. A player who took over the id
+        // of one who left this tick is a different join: the old one is
+        // sent as left and the new one in full.
+        std::size_t j = 0;
+        for (const Tracked& t : tracked) {
+            const ArenaPlayer* p = j < arena.players.size() && arena.players[j].joinSerial == t.joinSerial ? &arena.players[j] : nullptr;
+            if (!p) {
+                deltaBits.write(3, 2);
+                deltaBits.write(0, 1);
+                continue;
+            }
+            ++j;
+            if (t.alive && p->alive) {
+                assert(std::abs(p->body[0].x - t.head.x) + std::abs(p->body[0].y - t.head.y) == 1);
+                deltaBits.write(0, 2);
+                deltaBits.write(stepDirection(t.head, p->body[0]), 2);
+                deltaBits.write(p->body.size() > t.length, 1);
+            } else if (!t.alive && !p->alive) {
+                deltaBits.write(1, 2);
+            } else if (t.alive) {
+                deltaBits.write(2, 2);
+                deltaBits.writeVar(static_cast<std::uint32_t>(p->score));
+            } else {
+                deltaBits.write(3, 2);
+                deltaBits.write(1, 1);
+                writePlayer(deltaBits, *p);
+            }
+        }
+        deltaBits.writeVar(static_cast<std::uint32_t>(arena.players.size() - j));
+        for (; j < arena.players.size(); ++j) {
+            deltaBits.write(arena.players[j].id, 16);
+            writePlayer(deltaBits, arena.players[j]);
+        }
+
+        std::size_t added = 0;
+        for (const sf::Vector2i& f : foods)
+            deltaBits.write(std::find(arena.foods.begin(), arena.foods.end(), f) != arena.foods.end(), 1);
+        for (const sf::Vector2i& f : arena.foods)
+            if (std::find(foods.begin(), foods.end(), f) == foods.end()) ++added;
+        deltaBits.writeVar(static_cast<std::uint32_t>(added));
+        for (const sf::Vector2i& f : arena.foods) {
+            if (std::find(foods.begin(), foods.end(), f) != foods.end()) continue;
+            deltaBits.write(f.x, xBits);
+            deltaBits.write(f.y, yBits);
+        }
+    }
+
+    void remember() {
+        tracked.clear();
+        for (const ArenaPlayer& p : arena.players) {
+            Tracked t = { p.id, p.joinSerial, p.alive, p.alive ? p.body[0] : SnakeSegment(0, 0), p.body.size() };
+            tracked.push_back(t);
+        }
+        foods = arena.foods;
+    }
+
+    const Arena& arena;
+    int xBits;
+    int yBits;
+    std::vector<Tracked> tracked;
+    std::vector<sf::Vector2i> foods;
+    BitWriter deltaBits;
+    BitWriter keyframeBits;
+    bool keyframeBuilt = false;
+};
+
+// --- Snapshot decoding ---
+class SnapshotDecoder {
+public:
+    SnapshotDecoder(int cols, int rows) : xBits(bitsFor(cols - 1)), yBits(bitsFor(rows - 1)) {}
+
+    bool readKeyframe(BitReader& in, std::uint32_t tick, ArenaSnapshot& snap) const {
+        ArenaSnapshot next;
+        next.tick = tick;
+        next.ackSeq = snap.ackSeq;
+        next.foods.resize(in.readVar());
+        for (sf::Vector2i& f : next.foods) {
+            f.x = static_cast<int>(in.read(xBits));
+            f.y = static_cast<int>(in.read(yBits));
+        }
+        std::uint32_t count = in.readVar();
+        for (std::uint32_t i = 0; i < count && in.ok(); ++i) {
+            SnapshotPlayer p;
+            p.id = static_cast<std::uint16_t>(in.read(16));
+            readPlayer(in, p);
+            next.players.push_back(std::move(p));
+        }
+        if (!in.ok()) return false;
+        next.valid = true;
+        snap = std::move(next);
+        return true;
+    }
+
+    // Only applies on top of tick - 1. On false the snapshot is unusable
+    // until the next keyframe.
+    bool applyDelta(BitReader& in, std::uint32_t tick, ArenaSnapshot& snap) const {
+        if (!snap.valid || tick != snap.tick + 1) return false;
+        std::vector<SnapshotPlayer> players;
+        players.reserve(snap.players.size());
+        for (SnapshotPlayer& p : snap.players) {
+            std::uint32_t op = in.read(2);
+            if (op == 0) {
+                if (p.body.empty()) return invalidate(snap);
+                p.dir = static_cast<Direction>(in.read(2));
+                p.body.push_front(stepFrom(p.body.front(), p.dir));
+                if (in.read(1)) ++p.score;
+                else p.body.pop_back();
+            } else if (op == 2) {
+                p.alive = false;
+                p.score = in.readVar();
+                p.body.clear();
+            } else if (op == 3) {
+                if (!in.read(1)) continue;  // left
+                readPlayer(in, p);
+            }
+            players.push_back(std::move(p));
+        }
+        std::uint32_t joined = in.readVar();
+        for (std::uint32_t i = 0; i < joined && in.ok(); ++i) {
+            SnapshotPlayer p;
+            p.id = static_cast<std::uint16_t>(in.read(16));
+            readPlayer(in, p);
+            players.push_back(std::move(p));
+        }
+
+        std::vector<sf::Vector2i> foods;
+        for (const sf::Vector2i& f : snap.foods)
+            if (in.read(1)) foods.push_back(f);
+        std::uint32_t added = in.readVar();
+        for (std::uint32_t i = 0; i < added && in.ok(); ++i) {
+            sf::Vector2i f;
+            f.x = static_cast<int>(in.read(xBits));
+            f.y = static_cast<int>(in.read(yBits));
+            foods.push_back(f);
+        }
+        if (!in.ok()) return invalidate(snap);
+        snap.players = std::move(players);
+        snap.foods = std::move(foods);
+        snap.tick = tick;
+        return true;
+    }
+
+private:
+    static bool invalidate(ArenaSnapshot& snap) {
+        snap.valid = false;
+        return false;
+    }
+
+    void readPlayer(BitReader& in, SnapshotPlayer& p) const {
+        p.alive = in.read(1) != 0;
+        p.score = in.readVar();
+        p.body.clear();
+        if (!p.alive) return;
+        p.dir = static_cast<Direction>(in.read(2));
+        std::uint32_t length = in.readVar();
+        int x = static_cast<int>(in.read(xBits));
+        int y = static_cast<int>(in.read(yBits));
+        SnakeSegment s(x, y);
+        p.body.push_back(s);
+        for (std::uint32_t i = 1; i < length && in.ok(); ++i) {
+            s = stepFrom(s, static_cast<Direction>(in.read(2)));
+            p.body.push_back(s);
+        }
+    }
+
+    int xBits;
+    int yBits;
+};
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game.hpp"
+#include "hudtext.hpp"
+
+// --- Menu layout format ---
+// Menu screens are laid out in a text file (resources/menus.txt):
+//
+//   # comment
+//   screen menu
+//   text   title 400 180 255,255,255 48 SERPENT RUSH
+//   button start 400 300 300 60 0,150,0 32 Start Game
+//
+// A button is a box (centre x y, size w h, colour) with a white label
+// centred on it; a text is a label alone (centre x y, colour). Both end
+// with the character size and the label, which runs to the end of the
+// line. Widgets are drawn in file order; ids are what the game looks
+// them up by.
+enum WidgetKind { WIDGET_BUTTON, WIDGET_TEXT };
+
+struct Widget {
+    WidgetKind kind = WIDGET_TEXT;
+    std::string id;
+    sf::Vector2f center;
+    sf::Vector2f size;  // buttons only
+    sf::Color color;    // the box for buttons, the label for texts
+    unsigned int textSize = 0;
+    std::string label;
+    bool visible = true;
+
+    sf::FloatRect box() const { return sf::FloatRect(center - size / 2.f, size); }
+};
+
+inline bool parseColor(const std::string& word, sf::Color& color) {
+    std::istringstream in(word);
+    int r, g, b;
+    char c1, c2;
+    if (!(in >> r >> c1 >> g >> c2 >> b) || c1 != ',' || c2 != ',' || !in.eof()) return false;
+    if (std::min({r, g, b}) < 0 || std::max({r, g, b}) > 255) return false;
+    color = sf::Color(static_cast<sf::Uint8>(r), static_cast<sf::Uint8>(g), static_cast<sf::Uint8>(b));
+    return true;
+}
+
+// --- Menu screen ---
+// One screen of widgets, kept ready to draw: every box is a quad in one
+// vertex array and every label is glyph quads in one array per character
+// size (each size is its own font texture), so a whole screen is a handful
+// of draw calls. A uniform grid over the window lists the widgets touching
+// each cell; the mouse is tested against the few in its cell.
+//
+// Screens are meant to be painted into a CachedLayer. paintAll() draws
+// everything; after that, changing a label or hiding a widget marks it
+// dirty and paintDirty() repaints just the area it covered, clipped, with
+// whatever else overlaps that area.
+class UiScreen {
+public:
+    static constexpr int gridCell = 50;  // px
+
+    UiScreen(const sf::Font& font, const std::string& name) : font(&font), name(name), boxes(sf::Quads) {}
+
+    const std::string& getName() const { return name; }
+
+    void add(const Widget& widget) {
+        widgets.push_back(widget);
+        placed.emplace_back();
+        rebuild();
+    }
+
+    // -1 when the screen has no such widget.
+    int indexOf(const std::string& id) const {
+        for (size_t i = 0; i < widgets.size(); ++i)
+            if (widgets[i].id == id) return static_cast<int>(i);
+        return -1;
+    }
+
+    const Widget& widget(int i) const { return widgets[i]; }
+
+    void setLabel(int i, const std::string& label) {
+        if (widgets[i].label == label) return;
+        widgets[i].label = label;
+        placed[i].dirty = true;
+        rebuild();
+    }
+
+    void setVisible(int i, bool visible) {
+        if (widgets[i].visible == visible) return;
+        widgets[i].visible = visible;
+        placed[i].dirty = true;
+        rebuild();
+    }
+
+    // The topmost visible button under p, or -1.
+    int hitTest(sf::Vector2f p) const {
+        int cell = cellAt(p.x, p.y);
+        if (cell < 0) return -1;
+        for (int k = cellStart[cell + 1] - 1; k >= cellStart[cell]; --k) {
+            int i = cellItems[k];
+            if (widgets[i].kind == WIDGET_BUTTON && widgets[i].box().contains(p)) return i;
+        }
+        return -1;
+    }
+
+    void paintAll(sf::RenderTarget& target) {
+        target.draw(boxes);
+        sf::RenderStates states;
+        for (const GlyphRun& run : runs) {
+            states.texture = &font->getTexture(run.size);
+            target.draw(run.quads, states);
+        }
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            placed[i].painted = widgets[i].visible ? placed[i].area : sf::FloatRect();
+            placed[i].dirty = false;
+        }
+    }
+
+    bool isDirty() const {
+        return std::any_of(placed.begin(), placed.end(), [](const Placed& p) { return p.dirty; });
+    }
+
+    // Repaints where dirty widgets were and are now: background first, then
+    // every widget touching that area, clipped to it.
+    void paintDirty(sf::RenderTarget& target, sf::Color background) {
+        const sf::Vector2f targetSize(target.getSize());
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            Placed& p = placed[i];
+            if (!p.dirty) continue;
+            p.dirty = false;
+            sf::FloatRect now = widgets[i].visible ? p.area : sf::FloatRect();
+            sf::FloatRect region = pixelAligned(merge(p.painted, now), targetSize);
+            p.painted = now;
+            if (region.width <= 0 || region.height <= 0) continue;
+
+            sf::View clip(region);
+            clip.setViewport(sf::FloatRect(region.left / targetSize.x, region.top / targetSize.y,
+                                           region.width / targetSize.x, region.height / targetSize.y));
+            target.setView(clip);
+            sf::RectangleShape patch(sf::Vector2f(region.width, region.height));
+            patch.setPosition(region.left, region.top);
+            patch.setFillColor(background);
+            target.draw(patch);
+
+            touching(region);
+            for (int j : scratch)
+                if (placed[j].boxCount) target.draw(&boxes[placed[j].boxFirst], placed[j].boxCount, sf::Quads);
+            for (int j : scratch) {
+                const Placed& q = placed[j];
+                if (!q.glyphCount) continue;
+                sf::RenderStates states(&font->getTexture(runs[q.run].size));
+                target.draw(&runs[q.run].quads[q.glyphFirst], q.glyphCount, sf::Quads, states);
+            }
+            target.setView(target.getDefaultView());
+        }
+    }
+
+private:
+    struct GlyphRun {
+        unsigned int size;
+        sf::VertexArray quads;
+    };
+
+    // Where a widget sits in the batches, and what it covers on screen.
+    struct Placed {
+        sf::FloatRect area;     // box and label
+        sf::FloatRect painted;  // area when last painted, empty if hidden
+        size_t boxFirst = 0, boxCount = 0;
+        size_t run = 0, glyphFirst = 0, glyphCount = 0;
+        bool dirty = true;
+    };
+
+    static sf::FloatRect merge(sf::FloatRect a, sf::FloatRect b) {
+        if (a.width <= 0 || a.height <= 0) return b;
+        if (b.width <= 0 || b.height <= 0) return a;
+        float left = std::min(a.left, b.left), top = std::min(a.top, b.top);
+        float right = std::max(a.left + a.width, b.left + b.width), bottom = std::max(a.top + a.height, b.top + b.height);
+        return sf::FloatRect(left, top, right - left, bottom - top);
+    }
+
+    // An area with room for the glyph padding and anti-aliased edges drawn
+    // just outside it.
+    static sf::FloatRect reach(sf::FloatRect a) {
+        if (a.width <= 0 || a.height <= 0) return a;
+        return sf::FloatRect(a.left - 2, a.top - 2, a.width + 4, a.height + 4);
+    }
+
+    // Whole pixels with a pixel of margin for anti-aliased edges, inside the target.
+    static sf::FloatRect pixelAligned(sf::FloatRect r, sf::Vector2f size) {
+        if (r.width <= 0 || r.height <= 0) return sf::FloatRect();
+        float left = std::max(0.f, std::floor(r.left) - 1), top = std::max(0.f, std::floor(r.top) - 1);
+        float right = std::min(size.x, std::ceil(r.left + r.width) + 1);
+        float bottom = std::min(size.y, std::ceil(r.top + r.height) + 1);
+        return sf::FloatRect(left, top, std::max(0.f, right - left), std::max(0.f, bottom - top));
+    }
+
+    GlyphRun& runFor(unsigned int size, size_t& index) {
+        for (index = 0; index < runs.size(); ++index)
+            if (runs[index].size == size) return runs[index];
+        runs.push_back(GlyphRun{size, sf::VertexArray(sf::Quads)});
+        return runs.back();
+    }
+
+    // Refills the batches and the grid. Labels are centred on their widget
+    // the way the hand-built menus centred an sf::Text on its local bounds.
+    void rebuild() {
+        boxes.clear();
+        for (GlyphRun& run : runs) run.quads.clear();
+        for (size_t i = 0; i < widgets.size(); ++i) {
+            const Widget& w = widgets[i];
+            Placed& p = placed[i];
+            p.boxCount = p.glyphCount = 0;
+            p.area = sf::FloatRect();
+            if (!w.visible) continue;
+
+            p.boxFirst = boxes.getVertexCount();
+            if (w.kind == WIDGET_BUTTON) {
+                sf::FloatRect r = w.box();
+                boxes.append(sf::Vertex(sf::Vector2f(r.left, r.top), w.color));
+                boxes.append(sf::Vertex(sf::Vector2f(r.left + r.width, r.top), w.color));
+                boxes.append(sf::Vertex(sf::Vector2f(r.left + r.width, r.top + r.height), w.color));
+                boxes.append(sf::Vertex(sf::Vector2f(r.left, r.top + r.height), w.color));
+                p.boxCount = 4;
+                p.area = r;
+            }
+
+            GlyphRun& run = runFor(w.textSize, p.run);
+            const float baseline = static_cast<float>(w.textSize);
+            float x = 0, minX = baseline, minY = baseline, maxX = 0, maxY = 0;
+            sf::Uint32 previous = 0;
+            for (char ch : w.label) {
+                sf::Uint32 c = static_cast<unsigned char>(ch);
+                x += font->getKerning(previous, c, w.textSize);
+                previous = c;
+                const sf::Glyph& g = font->getGlyph(c, w.textSize, false);
+                if (c == ' ') {
+                    // Spaces count towards the bounds as sf::Text counts them.
+                    minX = std::min(minX, x);
+                    minY = std::min(minY, baseline);
+                    x += g.advance;
+                    maxX = std::max(maxX, x);
+                    maxY = std::max(maxY, baseline);
+                    continue;
+                }
+                minX = std::min(minX, x + g.bounds.left);
+                maxX = std::max(maxX, x + g.bounds.left + g.bounds.width);
+                minY = std::min(minY, baseline + g.bounds.top);
+                maxY = std::max(maxY, baseline + g.bounds.top + g.bounds.height);
+                x += g.advance;
+            }
+            if (w.label.empty()) minX = maxX = minY = maxY = 0;
+            const sf::Vector2f offset = w.center - sf::Vector2f((minX + maxX) / 2, (minY + maxY) / 2);
+            const sf::Color textColor = w.kind == WIDGET_BUTTON ? sf::Color::White : w.color;
+
+            p.glyphFirst = run.quads.getVertexCount();
+            run.quads.resize(p.glyphFirst + w.label.size() * 4);
+            x = 0;
+            previous = 0;
+            for (size_t k = 0; k < w.label.size(); ++k) {
+                sf::Uint32 c = static_cast<unsigned char>(w.label[k]);
+                x += font->getKerning(previous, c, w.textSize);
+                previous = c;
+                const sf::Glyph& g = font->getGlyph(c, w.textSize, false);
+                setGlyphQuad(&run.quads[p.glyphFirst + k * 4], g, offset.x + x, offset.y + baseline, textColor);
+                x += g.advance;
+            }
+            p.glyphCount = w.label.size() * 4;
+            p.area = merge(p.area, sf::FloatRect(offset.x + minX, offset.y + minY, maxX - minX, maxY - minY));
+        }
+        index();
+    }
+
+    int cellAt(float x, float y) const {
+        if (x < 0 || y < 0) return -1;
+        int cx = static_cast<int>(x) / gridCell, cy = static_cast<int>(y) / gridCell;
+        if (cx >= gridCols() || cy >= gridRows()) return -1;
+        return cy * gridCols() + cx;
+    }
+
+    static int gridCols() { return (width + gridCell - 1) / gridCell; }
+    static int gridRows() { return (height + gridCell - 1) / gridCell; }
+
+    // Calls f(cell) for every grid cell r overlaps.
+    template <typename Fn>
+    static void forCells(sf::FloatRect r, Fn f) {
+        if (r.width <= 0 || r.height <= 0) return;
+        int x0 = std::max(0, static_cast<int>(std::floor(r.left)) / gridCell);
+        int y0 = std::max(0, static_cast<int>(std::floor(r.top)) / gridCell);
+        int x1 = std::min(gridCols() - 1, static_cast<int>(std::ceil(r.left + r.width)) / gridCell);
+        int y1 = std::min(gridRows() - 1, static_cast<int>(std::ceil(r.top + r.height)) / gridCell);
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x) f(y * gridCols() + x);
+    }
+
+    // Buckets visible widgets by cell, in file order within each cell.
+    void index() {
+        const int cells = gridCols() * gridRows();
+        cellStart.assign(cells + 1, 0);
+        for (size_t i = 0; i < widgets.size(); ++i)
+            forCells(reach(placed[i].area), [&](int c) { ++cellStart[c + 1]; });
+        for (int c = 0; c < cells; ++c) cellStart[c + 1] += cellStart[c];
+        cellItems.resize(cellStart[cells]);
+        std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < widgets.size(); ++i)
+            forCells(reach(placed[i].area), [&](int c) { cellItems[fill[c]++] = static_cast<int>(i); });
+    }
+
+    // Fills scratch with the visible widgets touching r, in file order.
+    void touching(sf::FloatRect r) {
+        scratch.clear();
+        forCells(r, [&](int c) {
+            for (int k = cellStart[c]; k < cellStart[c + 1]; ++k)
+                if (reach(placed[cellItems[k]].area).intersects(r)) scratch.push_back(cellItems[k]);
+        });
+        std::sort(scratch.begin(), scratch.end());
+        scratch.erase(std::unique(scratch.begin(), scratch.end()), scratch.end());
+    }
+
+    const sf::Font* font;
+    std::string name;
+    std::vector<Widget> widgets;
+    std::vector<Placed> placed;
+    sf::VertexArray boxes;
+    std::vector<GlyphRun> runs;
+    std::vector<int> cellStart, cellItems;
+    std::vector<int> scratch;
+};
+
+// --- Menu layout ---
+// The screens of a menu file, looked up by name.
+class UiLayout {
+public:
+    explicit UiLayout(const sf::Font& font) : font(font) {}
+
+    bool load(std::istream& in, std::string& error) {
+        screens.clear();
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(in, line)) {
+            ++lineNo;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            std::istringstream words(line);
+            std::string key;
+            if (!(words >> key) || key[0] == '#') continue;
+            bool ok = true;
+            if (key == "screen") {
+                std::string name;
+                ok = static_cast<bool>(words >> name) && !screen(name);
+                if (ok) screens.emplace_back(font, name);
+            } else if (key == "button" || key == "text") {
+                Widget w;
+                std::string color;
+                w.kind = key == "button" ? WIDGET_BUTTON : WIDGET_TEXT;
+                ok = !screens.empty() && static_cast<bool>(words >> w.id >> w.center.x >> w.center.y);
+                if (ok && w.kind == WIDGET_BUTTON) ok = words >> w.size.x >> w.size.y && w.size.x > 0 && w.size.y > 0;
+                ok = ok && (words >> color >> w.textSize) && parseColor(color, w.color) && w.textSize > 0;
+                if (ok) std::getline(words >> std::ws, w.label);
+                ok = ok && screens.back().indexOf(w.id) < 0;
+                if (ok) screens.back().add(w);
+            } else {
+                ok = false;
+            }
+            if (!ok) {
+                error = "line " + std::to_string(lineNo) + ": bad '" + key + "' entry";
+                return false;
+            }
+        }
+        if (screens.empty()) {
+            error = "no screens";
+            return false;
+        }
+        return true;
+    }
+
+    // nullptr when the file has no such screen.
+    UiScreen* screen(const std::string& name) {
+        for (UiScreen& s : screens)
+            if (s.getName() == name) return &s;
+        return nullptr;
+    }
+
+private:
+    const sf::Font& font;
+    std::vector<UiScreen> screens;
+};